@@ -0,0 +1,119 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   cmdarg.h
+ *  \brief  Centralised parsing of typed command arguments.
+ *
+ *  Numbers are converted four characters at a time (SWAR) instead of 
+ *  one multiply-and-branch per digit as strtoul() does, which pays off 
+ *  on small MCUs without a fast divider or a deep pipeline.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* --------------------------------- Module -------------------------------- */
+#ifndef __CMDARG_H__
+#define __CMDARG_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** 
+ * Byte order of target. SWAR conversion is used on little endian 
+ * targets only, big endian ones use the plain loop.
+ */
+#define CMDARG_LITTLE_ENDIAN    1
+
+/** Return codes of cmdarg_parse() other than the index of a bad argument */
+#define CMDARG_OK               0
+#define CMDARG_COUNT            (-1)
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Convert a signed decimal string.
+ *
+ *  \return
+ *  0 on success, otherwise 1 (not a number or overflow).
+ */
+int cmdarg_dec(const char *s, long *v);
+
+/**
+ *  \brief
+ *  Convert a hexadecimal string, with optional 0x prefix.
+ *
+ *  \return
+ *  0 on success, otherwise 1 (not a number or overflow).
+ */
+int cmdarg_hex(const char *s, unsigned long *v);
+
+/**
+ *  \brief
+ *  Parse and validate the arguments of a command against its schema.
+ *
+ *  \param[in]  ext     extended attributes holding the schema
+ *  \param[in]  argc    number of arguments, command name included
+ *  \param[in]  argv    arguments
+ *  \param[out] vals    typed arguments, vals[i] for argv[i]
+ *
+ *  \return
+ *  CMDARG_OK       all arguments are valid
+ *  CMDARG_COUNT    too few or too many arguments
+ *  > 0             index of the first bad argument
+ */
+int cmdarg_parse(const CMD_EXT *ext, MInt argc, char *argv[], CMD_VAL *vals);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
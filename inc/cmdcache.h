@@ -0,0 +1,135 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   cmdcache.h
+ *  \brief  Result cache of idempotent read-only commands.
+ *
+ *  A command opts in by setting a time-to-live in its extended 
+ *  attributes. Its rendered output is captured at the conser boundary 
+ *  and kept in a bounded cache keyed by the normalised command line, so 
+ *  repeats within the time-to-live are served without calling the 
+ *  handler. Only successful runs whose output fits in an entry are kept.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* --------------------------------- Module -------------------------------- */
+#ifndef __CMDCACHE_H__
+#define __CMDCACHE_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Include the result cache */
+#define CMDCACHE                0
+
+#if CMDCACHE
+#define CMDCACHE_TX(s, n)       cmdcache_tx((s), (n))
+#else
+#define CMDCACHE_TX(s, n)
+#endif
+
+/* -------------------------------- Constants ------------------------------ */
+/** Number of entries */
+#define CMDCACHE_ENTRIES        4
+
+/** Largest output kept by an entry */
+#define CMDCACHE_DATA           128
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct CmdCacheStat CmdCacheStat;
+struct CmdCacheStat
+{
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long toobig;       /* outputs that did not fit in an entry */
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Serve the command from the cache if a fresh result is kept, otherwise 
+ *  start capturing its output.
+ *
+ *  \return
+ *  1 if the result was served, so the handler must not be called.
+ */
+int cmdcache_begin(const CMD_TABLE *cmdtp, MInt argc, char *argv[]);
+
+/**
+ *  \brief
+ *  Stop capturing and keep the result if the handler succeeded. Any other
+ *  code, CMD_MORE included, drops it.
+ */
+void cmdcache_end(MInt rc);
+
+/**
+ *  \brief
+ *  Capture n output bytes. Called by conser module.
+ */
+void cmdcache_tx(const char *s, unsigned int n);
+
+/**
+ *  \brief
+ *  Discard every kept result.
+ */
+void cmdcache_flush(void);
+
+/**
+ *  \brief
+ *  Get the counters.
+ */
+void cmdcache_stat(CmdCacheStat *st);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,143 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   cmdreg.h
+ *  \brief  Runtime registry of commands.
+ *
+ *  Commands can be added and removed at run time, e.g. by a plugin loaded 
+ *  with dlopen() on host builds, on top of the built-in table, which 
+ *  always takes precedence. Lookups never block: readers run inside a 
+ *  read section, and writers publish a new copy of the registry and then 
+ *  wait until every read section that could see the old copy has ended, 
+ *  so a removed entry is never freed under a running dispatch.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The shell holds a read section from lookup to the return of the 
+ *  handler. Writers must not run inside one, so cmdreg_add() and 
+ *  cmdreg_remove() can't be called from command handlers, they would 
+ *  wait for themselves.
+ *
+ *  Scripts keep their commands by name and look them up each time they 
+ *  run, so a command may be removed while a script using it is stored. 
+ *  Running the script then stops at that line with "Unknown command".
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __CMDREG_H__
+#define __CMDREG_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Give up the processor while waiting for readers or other writers */
+#define CMDREG_YIELD()          sched_yield()
+
+/* -------------------------------- Constants ------------------------------ */
+/** Include the runtime registry */
+#define CMDREG                  0
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Add a command. The entry must live until it is removed.
+ *
+ *  \return
+ *  0 on success, 1 if the name is already registered or out of memory.
+ */
+int cmdreg_add(const CMD_TABLE *cmd);
+
+/**
+ *  \brief
+ *  Remove a command. On return no dispatch uses its entry anymore, so it 
+ *  may be freed or its plugin unloaded.
+ *
+ *  \return
+ *  0 on success, 1 if it is unknown or out of memory.
+ */
+int cmdreg_remove(const char *name);
+
+/**
+ *  \brief
+ *  Enter a read section, they nest.
+ *
+ *  \return
+ *  Token to pass to cmdreg_read_unlock().
+ */
+unsigned int cmdreg_read_lock(void);
+
+/**
+ *  \brief
+ *  Leave a read section.
+ */
+void cmdreg_read_unlock(unsigned int token);
+
+/**
+ *  \brief
+ *  Find a registered command, with the same rules as find_cmd(). Call it 
+ *  inside a read section, the entry is valid until its end.
+ */
+const CMD_TABLE *cmdreg_find(const char *cmd);
+
+/**
+ *  \brief
+ *  Get the i-th registered command, NULL past the last one. Call it 
+ *  inside a read section.
+ */
+const CMD_TABLE *cmdreg_at(unsigned int i);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
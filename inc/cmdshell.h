@@ -61,6 +61,8 @@
 /* ------------------------------ Module end ------------------------------- */
 #include "mytypes.h"
 #include "command.h"
+#include "simtrace.h"
+#include "simshell.h"
 
 #define CMD_TBL_SHELL \
     MK_CMD_TBL_ENTRY(               \
@@ -69,5 +71,39 @@
         NULL                                                \
         ),
 
+#if SIMTRACE
+#define CMD_TBL_TRACE \
+    MK_CMD_TBL_ENTRY(               \
+        "trace", 3, 2, do_trace,                       \
+        "trace\t- dump shell trace ring\n",                 \
+        "[clear|bin]\n"                                     \
+        "\t- Without arguments, print stored events, oldest first\n" \
+        "\t  'clear' discards stored events\n"              \
+        "\t  'bin' streams them in binary form\n"           \
+        ),
+#else
+#define CMD_TBL_TRACE
+#endif
+
+#if RAWLINE
+#define CMD_TBL_LINE \
+    MK_CMD_TBL_ENTRY_EXT(           \
+        "line", 4, 2, NULL,                            \
+        "line\t- set console line mode\n",                 \
+        "[edit|raw|tag]\n"                                  \
+        "\t- Without arguments, print current mode\n"      \
+        "\t  'edit' echoes and edits input on device\n"    \
+        "\t  'raw' takes finished lines from a host client\n" \
+        "\t  without echo, see tools/simcli.c\n"           \
+        "\t  'tag' takes tagged requests, see tagreq.h\n", \
+        &line_ext                                           \
+        ),
+#else
+#define CMD_TBL_LINE
+#endif
+
+extern const CMD_EXT line_ext;
+
 MInt do_shell(const CMD_TABLE *p, MInt argc, char *argv[]);
+MInt do_trace(const CMD_TABLE *p, MInt argc, char *argv[]);
 /* ------------------------------ End of file ------------------------------ */
@@ -62,6 +62,7 @@
 #ifndef __COMMAND_H__
 #define __COMMAND_H__
 
+#include <stddef.h>
 #include "mytypes.h"
 
 /*
@@ -97,12 +98,119 @@
 
 #if LONGHELP
 #define MK_CMD_TBL_ENTRY(name, lmin, maxargs, cmd, usage, help)  \
-    {name, lmin, maxargs, cmd, usage, help}
+    {name, lmin, maxargs, cmd, usage, help, NULL}
+#define MK_CMD_TBL_ENTRY_EXT(name, lmin, maxargs, cmd, usage, help, ext)  \
+    {name, lmin, maxargs, cmd, usage, help, ext}
 #else
 #define MK_CMD_TBL_ENTRY(name, lmin, maxargs, cmd, usage, help)  \
-    {name, lmin, maxargs, cmd, usage}
+    {name, lmin, maxargs, cmd, usage, NULL}
+#define MK_CMD_TBL_ENTRY_EXT(name, lmin, maxargs, cmd, usage, help, ext)  \
+    {name, lmin, maxargs, cmd, usage, ext}
 #endif
 
+/*
+ *      Typed arguments. A command declares the schema of its arguments 
+ *      in its extended attributes and the shell parses and validates 
+ *      them before calling the typed handler 'run'. For instance:
+ *
+ *      static const char *const onoff[] = {"off", "on", NULL};
+ *
+ *      static const CMD_ARG outp_args[] =
+ *      {
+ *          MK_ARG_HEX("port"),
+ *          MK_ARG_RANGE("value", 0, 255),
+ *          MK_ARG_ENUM("mode", onoff)
+ *      };
+ *
+ *      static const CMD_EXT outp_ext = {outp_args, 3, 2, do_outp};
+ *
+ *      MK_CMD_TBL_ENTRY_EXT("outp", 4, 4, NULL, "outp\t- ...\n", NULL,
+ *                           &outp_ext),
+ *
+ *      The handler gets vals[i] for argv[i], vals[0].s is the command name.
+ */
+
+#define MK_ARG_INT(name)                {CMD_ARG_INT, name, 0, 0, NULL}
+#define MK_ARG_HEX(name)                {CMD_ARG_HEX, name, 0, 0, NULL}
+#define MK_ARG_RANGE(name, min, max)    {CMD_ARG_RANGE, name, min, max, NULL}
+#define MK_ARG_ENUM(name, keys)         {CMD_ARG_ENUM, name, 0, 0, keys}
+#define MK_ARG_STR(name)                {CMD_ARG_STR, name, 0, 0, NULL}
+
+enum
+{
+    CMD_ARG_INT,        /* signed decimal, vals[i].i */
+    CMD_ARG_HEX,        /* hexadecimal, optional 0x prefix, vals[i].u */
+    CMD_ARG_RANGE,      /* signed decimal within [min, max], vals[i].i */
+    CMD_ARG_ENUM,       /* one of keys, vals[i].i is its index */
+    CMD_ARG_STR         /* any string, vals[i].s */
+};
+
+typedef struct cmd_arg_s
+{
+    unsigned char type; /* CMD_ARG_xxx                  */
+    const char *name;   /* shown by usage errors        */
+    long min, max;      /* CMD_ARG_RANGE limits         */
+    const char *const *keys; /* CMD_ARG_ENUM, NULL terminated */
+} CMD_ARG;
+
+typedef union cmd_val_u
+{
+    long i;
+    unsigned long u;
+    const char *s;
+} CMD_VAL;
+
+struct cmd_tbl_s;
+
+/*
+ *      Extended attributes of a command. Unused trailing members
+ *      may be omitted from initializers. For instance, an untyped 
+ *      read-only command whose output may be reused for 100 ticks:
+ *
+ *      static const CMD_EXT stat_ext = {NULL, 0, 0, NULL, 100};
+ */
+
+typedef struct cmd_ext_s
+{
+    const CMD_ARG *args;    /* typed argument schema        */
+    MInt nargs;             /* number of arguments in schema */
+    MInt nreq;              /* number of required arguments */
+    MInt (*run)(const struct cmd_tbl_s *tbl, MInt argc, const CMD_VAL *vals);
+    unsigned int ttl;       /* result time-to-live in ticks of */
+                            /* idempotent commands, 0 if none  */
+    unsigned int deadline;  /* execution deadline in ticks,    */
+                            /* 0 for the shell-wide default    */
+    const struct cmd_tbl_s *sub; /* commands of a group, NULL  */
+                            /* terminated, NULL if not a group */
+} CMD_EXT;
+
+/*
+ *      Command groups. A group is an entry with no handler whose 
+ *      commands are in a table of its own, e.g. 'net stat' runs 'stat' 
+ *      of group 'net'. Lookup goes down one argument at a time, so 
+ *      names and abbreviations only have to be unique within a table, 
+ *      and 'help net' lists the commands of 'net' alone:
+ *
+ *      static const CMD_TABLE net_tbl[] =
+ *      {
+ *          MK_CMD_TBL_ENTRY("stat", 4, 1, do_net_stat, 
+ *                           "stat\t- show link counters\n", NULL),
+ *          MK_CMD_TBL_ENTRY(NULL, 0, 0, NULL, NULL, NULL)
+ *      };
+ *
+ *      static const CMD_EXT net_ext = MK_CMD_GROUP_EXT(net_tbl);
+ *
+ *      MK_CMD_TBL_GROUP("net", 3, "net\t- network commands\n", &net_ext),
+ *
+ *      Groups may hold groups. A handler gets argv[0] = its own name.
+ */
+
+#define MK_CMD_GROUP_EXT(tbl)   {NULL, 0, 0, NULL, 0, 0, tbl}
+#define MK_CMD_TBL_GROUP(name, lmin, usage, ext)  \
+    MK_CMD_TBL_ENTRY_EXT(name, lmin, MAXARGS, NULL, usage, NULL, ext)
+
+#define cmd_is_group(p)         ((p)->ext != NULL && (p)->ext->sub != NULL)
+
 typedef struct cmd_tbl_s
 {
     char *name;         /* command name					*/
@@ -113,9 +221,43 @@ typedef struct cmd_tbl_s
 #if LONGHELP
     char *help;         /* Help  message	(long)		*/
 #endif
+    const CMD_EXT *ext; /* extended attributes or NULL  */
 } CMD_TABLE;
 
+/*
+ *      Long handlers. A handler that would hold the caller of the shell 
+ *      too long may stop once cmd_yield() is true and return CMD_MORE, 
+ *      keeping its progress in static storage. The shell calls it again 
+ *      with the same arguments on its next turn, before reading any 
+ *      input, and cmd_resumed() is true then. For instance:
+ *
+ *      static unsigned int next;
+ *
+ *      if (!cmd_resumed())
+ *      {
+ *          next = 0;
+ *      }
+ *      for (; next < NUM_ROWS; ++next)
+ *      {
+ *          print_row(next);
+ *          if (cmd_yield())
+ *          {
+ *              ++next;
+ *              return CMD_MORE;
+ *          }
+ *      }
+ *      return 0;
+ */
+
+#define CMD_MORE            2
+
+int cmd_yield(void);
+int cmd_resumed(void);
+
 const CMD_TABLE *find_cmd(const char *cmd);
+const CMD_TABLE *find_tbl_cmd(const char *cmd);
+const CMD_TABLE *find_cmd_in(const CMD_TABLE *tbl, const char *cmd);
+void list_cmds(const CMD_TABLE *tbl);
 
 #endif
 /* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,122 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   conabort.h
+ *  \brief  Out-of-band ^C.
+ *
+ *  The receive isr of the console passes every byte to conabort_rx() 
+ *  before queuing it:
+ *
+ *      void uart_rx_isr(void)
+ *      {
+ *          unsigned char c = UART_DATA;
+ *
+ *          if (!conabort_rx(c))
+ *          {
+ *              queue c
+ *          }
+ *      }
+ *
+ *  ^C is then taken out of the stream as soon as it arrives, instead of 
+ *  waiting behind the input queued before it. The running handler is 
+ *  cancelled at once, see cmd_cancelled(), and the shell abandons the 
+ *  line being typed. If CONABORT_FLUSH is set, the input queued so far 
+ *  and the type-ahead queue are discarded too.
+ *
+ *  With VCHAN the receive isr must not call it: 0x03 may be a byte of a 
+ *  COBS frame of any channel. conser_init() sets it as the filter of the 
+ *  shell channel instead, so it sees the console bytes once they are out 
+ *  of their frames, as the shell polls the link.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Input arriving between ^C and the next poll of the shell is 
+ *  discarded along with the backlog.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __CONABORT_H__
+#define __CONABORT_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include out-of-band ^C */
+#define CONABORT                0
+
+/** Discard pending input on ^C */
+#define CONABORT_FLUSH          1
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Look at a received byte. Called from the receive isr.
+ *
+ *  \return
+ *  1 if it was ^C and must not be queued, otherwise 0.
+ */
+int conabort_rx(unsigned char c);
+
+/**
+ *  \brief
+ *  Take the abort request, if any. Called by the shell.
+ *
+ *  \return
+ *  1 if ^C arrived since the last call, otherwise 0.
+ */
+int conabort_take(void);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,137 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   conlog.h
+ *  \brief  Asynchronous log records shown between keystrokes.
+ *
+ *  Subsystems, isrs and other tasks log through conlog_puts(), which only 
+ *  copies the text into a free slot of a lock-free ring and returns. The 
+ *  shell drains the ring while it waits for input: it erases the prompt 
+ *  line, prints the pending records and redraws the prompt with the 
+ *  half-typed line, so log output never tears operator input.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Any number of producers, a single consumer, the shell. Producers claim 
+ *  a slot with compare-and-swap, so a port needs CONLOG_CAS() and 
+ *  CONLOG_BARRIER(), GCC builtins by default. On a single core without 
+ *  them, CONLOG_CAS() may be a few lines inside a critical section.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __CONLOG_H__
+#define __CONLOG_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Atomically replace *p by n if it is o, true if it did */
+#define CONLOG_CAS(p, o, n)     __sync_bool_compare_and_swap(p, o, n)
+
+/** Full memory barrier */
+#define CONLOG_BARRIER()        __sync_synchronize()
+
+/* -------------------------------- Constants ------------------------------ */
+/** Include asynchronous log */
+#define CONLOG                  0
+
+/** Number of records. It must be a power of 2 */
+#define CONLOG_SLOTS            8
+
+/** Longest record, '\0' included */
+#define CONLOG_LEN              48
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct ConLogStat ConLogStat;
+struct ConLogStat
+{
+    unsigned long records;      /* printed records */
+    unsigned long dropped;      /* records dropped because ring was full */
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Log a record, truncated to CONLOG_LEN - 1 bytes. It never blocks, so 
+ *  it may be called from isrs. A trailing end of line is not needed.
+ *
+ *  \return
+ *  0 if logged, 1 if dropped because the ring is full.
+ */
+int conlog_puts(const char *s);
+
+/**
+ *  \brief
+ *  True if there is a record ready to be printed.
+ */
+int conlog_pending(void);
+
+/**
+ *  \brief
+ *  Take the oldest record. Only the shell calls it.
+ *
+ *  \param[out] rec '\0' terminated record, CONLOG_LEN bytes
+ *
+ *  \return
+ *  Record length or -1 if there is none ready.
+ */
+int conlog_get(char *rec);
+
+/**
+ *  \brief
+ *  Get the counters.
+ */
+void conlog_stat(ConLogStat *st);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,146 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   conring.h
+ *  \brief  Capture of console output while nobody is attached.
+ *
+ *  While the console is detached, output of the shell and its commands 
+ *  goes to a ring of CONRING_SIZE bytes instead of the transmit path, 
+ *  overwriting the oldest bytes when full. Handlers never wait for a 
+ *  link nobody reads. 'replay' shows the captured output later.
+ *
+ *  The console is detached by conring_detach(), e.g. when the port sees 
+ *  the host going away, or while the bound transport tells that no peer 
+ *  is attached, see transport.h.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* --------------------------------- Module -------------------------------- */
+#ifndef __CONRING_H__
+#define __CONRING_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include the capture ring */
+#define CONRING                 0
+
+/** Size of ring. It must be a power of 2 */
+#define CONRING_SIZE            1024
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct ConRingStat ConRingStat;
+struct ConRingStat
+{
+    unsigned long captured;     /* bytes written since last clear */
+    unsigned long lost;         /* of them, overwritten */
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Detach the console, or attach it again.
+ */
+void conring_detach(int detached);
+
+/**
+ *  \brief
+ *  True if the console was detached by conring_detach().
+ */
+int conring_detached(void);
+
+/**
+ *  \brief
+ *  Store output, overwriting the oldest bytes if full.
+ */
+void conring_write(const char *s, unsigned int n);
+
+/**
+ *  \brief
+ *  Position of the oldest byte kept.
+ */
+unsigned long conring_first(void);
+
+/**
+ *  \brief
+ *  Copy captured bytes from a position on and advance it. A position 
+ *  already overwritten moves to the oldest byte kept.
+ *
+ *  \return
+ *  Bytes copied, 0 once the newest one was read.
+ */
+unsigned int conring_read(unsigned long *pos, char *buf, unsigned int len);
+
+void conring_clear(void);
+void conring_stat(ConRingStat *st);
+
+MInt do_replay(const CMD_TABLE *p, MInt argc, char *argv[]);
+
+#if CONRING
+#define CMD_TBL_REPLAY \
+    MK_CMD_TBL_ENTRY(               \
+        "replay", 3, 2, do_replay,                     \
+        "replay\t- show output captured while detached\n",  \
+        "[clear]\n"                                         \
+        "\t- Without arguments, print the output captured\n" \
+        "\t  while nobody was attached to the console\n"    \
+        "\t  'clear' forgets it\n"                          \
+        ),
+#else
+#define CMD_TBL_REPLAY
+#endif
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -76,4 +76,27 @@ extern MUInt tcmd;
  */
 
 void set_cmd_timeout(MUInt tout);
+
+/*
+ *      Period of timer isr in microseconds.
+ */
+
+#define CONTICK_PERIOD_US       1000
+
+/*
+ *      Free running tick counter. It is upgrade from timer isr
+ *      by calling contick_tick().
+ */
+
+extern volatile unsigned long ctick;
+
+#define contick_now()           (ctick)
+
+/*
+ * contick_tick:
+ *
+ *      Advance the free running tick counter. Call it from timer isr.
+ */
+
+void contick_tick(void);
 /* ------------------------------ End of file ------------------------------ */
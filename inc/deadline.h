@@ -0,0 +1,140 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   deadline.h
+ *  \brief  Execution deadlines of command handlers.
+ *
+ *  Every handler runs under a deadline, its own one from the extended 
+ *  attributes or the shell-wide default. A handler can not be preempted, 
+ *  so the deadline is enforced cooperatively: when it expires the timer 
+ *  isr sets the cancellation token, which long running handlers must poll 
+ *  by means of cmd_cancelled() and then return as soon as possible. ^C 
+ *  received while a handler runs sets the token too.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* --------------------------------- Module -------------------------------- */
+#ifndef __DEADLINE_H__
+#define __DEADLINE_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Include the execution deadlines */
+#define DEADLINE                0
+
+/**
+ *  \brief
+ *  True if the running handler must give up. It costs one load.
+ */
+#define cmd_cancelled()         (deadline_token != CANCEL_NONE)
+
+/* -------------------------------- Constants ------------------------------ */
+/** Shell-wide deadline in ticks, 0 means no deadline */
+#define DEADLINE_DEFAULT        0
+
+/** Reasons of cancellation */
+enum
+{
+    CANCEL_NONE, CANCEL_DEADLINE, CANCEL_CTRLC
+};
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct DeadlineStat DeadlineStat;
+struct DeadlineStat
+{
+    unsigned long overruns;     /* deadlines expired, counted by timer */
+    unsigned long aborts;       /* handlers cancelled by ^C */
+    unsigned long worst;        /* longest overshoot in ticks */
+};
+
+/* -------------------------- External variables --------------------------- */
+/** Cancellation token, CANCEL_xxx */
+extern volatile unsigned char deadline_token;
+
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Arm the deadline before calling a handler and clear the token.
+ *
+ *  \param[in]  ticks   deadline, 0 means no deadline
+ */
+void deadline_start(unsigned int ticks);
+
+/**
+ *  \brief
+ *  Disarm the deadline after the handler returns.
+ *
+ *  \return
+ *  Overshoot in ticks, 0 if the handler met its deadline.
+ */
+unsigned long deadline_stop(void);
+
+/**
+ *  \brief
+ *  Check the deadline. Called from timer isr by contick_tick().
+ */
+void deadline_tick(void);
+
+/**
+ *  \brief
+ *  Cancel the running handler, if any.
+ */
+void deadline_cancel(unsigned char reason);
+
+/**
+ *  \brief
+ *  Get the counters.
+ */
+void deadline_stat(DeadlineStat *st);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
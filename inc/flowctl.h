@@ -0,0 +1,171 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+
+/**
+ *  \file   flowctl.h
+ *  \brief  Flow control of console input.
+ *
+ *  Keeps count of the bytes received but not yet read by the shell. When 
+ *  they reach FLOWCTL_HIGH the host is told to stop, by XOFF and RTS, and 
+ *  when the shell has read them down to FLOWCTL_LOW it is told to go on, 
+ *  by XON and RTS. A host may then send a script at full line rate, 
+ *  without delays between lines.
+ *
+ *  The receive isr of the console calls flowctl_rx() for every byte 
+ *  queued, after conabort_rx() if any:
+ *
+ *      void uart_rx_isr(void)
+ *      {
+ *          unsigned char c = UART_DATA;
+ *
+ *          if (!conabort_rx(c))
+ *          {
+ *              queue c
+ *              flowctl_rx();
+ *          }
+ *      }
+ *
+ *  and conser takes the bytes read by the shell off the count. Define 
+ *  FLOWCTL_SEND() to put XON and XOFF on the line at once, ahead of 
+ *  queued output, and FLOWCTL_RTS() to drive the RTS pin, if wired. A 
+ *  transport bound by conser_bind() uses its own rts() instead. Its 
+ *  receive side calls flowctl_rx() in the same way.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The host may go on sending for a while after XOFF, until it sees it, 
+ *  so the room left above FLOWCTL_HIGH must hold what it sends in that 
+ *  time, e.g. its own FIFO. Bytes received while stopped are counted as 
+ *  late, a growing count means FLOWCTL_HIGH is too high.
+ *
+ *  Only the input queue is counted. Bytes the type-ahead queue takes are 
+ *  off the count, but it leaves input queued once its arena is full, see 
+ *  tahead.h, so the count rises and the host is stopped all the same.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __FLOWCTL_H__
+#define __FLOWCTL_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Put a byte on the line at once, e.g. (UART_DATA = (c)) */
+#define FLOWCTL_SEND(c)
+
+/** Drive RTS, ready to receive or not, e.g. (RTS_PIN = !(ready)) */
+#define FLOWCTL_RTS(ready)
+
+/* -------------------------------- Constants ------------------------------ */
+/** Include flow control of console input */
+#define FLOWCTL                 0
+
+/** Send XON and XOFF, besides driving RTS */
+#define FLOWCTL_XONXOFF         1
+
+/** Bytes pending to stop the host at */
+#define FLOWCTL_HIGH            48
+
+/** Bytes pending to resume the host at */
+#define FLOWCTL_LOW             16
+
+#define FLOWCTL_XON             0x11
+#define FLOWCTL_XOFF            0x13
+
+#if FLOWCTL
+#define FLOWCTL_TAKE()          flowctl_take()
+#else
+#define FLOWCTL_TAKE()
+#endif
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct FlowCtlStat FlowCtlStat;
+struct FlowCtlStat
+{
+    unsigned long xoffs;        /* times the host was stopped */
+    unsigned long late;         /* bytes received while stopped */
+    unsigned int pending;       /* bytes not read yet */
+    unsigned int peak;          /* most bytes pending */
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Count a byte received. Called from the receive isr.
+ */
+void flowctl_rx(void);
+
+/**
+ *  \brief
+ *  Count a byte read by the shell, called by conser.
+ */
+void flowctl_take(void);
+
+/**
+ *  \brief
+ *  Forget pending bytes, e.g. once the input queue is flushed, and 
+ *  tell the host to send.
+ */
+void flowctl_reset(void);
+
+void flowctl_stat(FlowCtlStat *st);
+
+/**
+ *  \brief
+ *  Tell the host to send or to stop, by the bound transport or by the 
+ *  line. Implemented by conser.
+ */
+void conser_flow(int ready);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,111 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   hexfmt.h
+ *  \brief  Table-driven hex formatting of memory rows.
+ *
+ *  A row shows the address, the data in groups of 1, 2 or 4 bytes and 
+ *  the data as text, e.g. for width 1:
+ *
+ *  20000010: 48 65 6c 6c 6f 0a 00 00 ff ff ff ff 12 34 56 78  Hello...
+ *
+ *  A whole row is formatted into a buffer, so that it can be sent at 
+ *  once. Every byte is encoded by a table lookup instead of a format 
+ *  string.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Groups of 2 and 4 bytes show the value in target byte order, as read 
+ *  by a halfword or word load.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __HEXFMT_H__
+#define __HEXFMT_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Bytes per row */
+#define HEXFMT_ROW              16
+
+/** Address digits */
+#define HEXFMT_ADDR             (2 * sizeof(unsigned long))
+
+/** Size of a row buffer, '\n' and '\0' included */
+#define HEXFMT_ROWLEN           (HEXFMT_ADDR + 2 + 3 * HEXFMT_ROW + \
+                                 1 + HEXFMT_ROW + 2)
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Format a row.
+ *
+ *  \param[out] out     row buffer, HEXFMT_ROWLEN bytes
+ *  \param[in]  addr    address shown
+ *  \param[in]  data    data
+ *  \param[in]  len     data bytes, up to HEXFMT_ROW. A short row is 
+ *                      padded, so that the text lines up.
+ *  \param[in]  width   group width, 1, 2 or 4. len must be a multiple.
+ *
+ *  \return
+ *  Length of the row, ending in '\n'.
+ */
+unsigned int hexfmt_row(char *out, unsigned long addr, 
+                        const unsigned char *data, unsigned int len, 
+                        unsigned int width);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,98 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   memdump.h
+ *  \brief  Memory dump command.
+ *
+ *  'dump addr len [width]' shows len bytes from addr in rows of 
+ *  HEXFMT_ROW bytes, see hexfmt.h. Memory is read in word loads where 
+ *  aligned, and every row is sent at once.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  A dump stops on ^C or when its deadline expires.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __MEMDUMP_H__
+#define __MEMDUMP_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include 'dump' command */
+#define MEMDUMP                 0
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+extern const CMD_EXT dump_ext;
+
+/* -------------------------- Function prototypes -------------------------- */
+#if MEMDUMP
+#define CMD_TBL_DUMP \
+    MK_CMD_TBL_ENTRY_EXT(           \
+        "dump", 4, 4, NULL,                            \
+        "dump\t- show memory in hex and text\n",            \
+        "addr len [1|2|4]\n"                                \
+        "\t- Show len bytes from hex address addr, in groups\n" \
+        "\t  of 1 (default), 2 or 4 bytes\n",               \
+        &dump_ext                                           \
+        ),
+#else
+#define CMD_TBL_DUMP
+#endif
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
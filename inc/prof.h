@@ -0,0 +1,208 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   prof.h
+ *  \brief  Sampling profiler.
+ *
+ *  While running, every tick samples the program counter of the 
+ *  interrupted code into a histogram of PROF_BUCKETS address ranges. 
+ *  'prof report' shows the PROF_TOP ranges with most samples, named by 
+ *  function when a symbol map is given.
+ *
+ *      prof start [lo hi]      clear and sample [lo, hi)
+ *      prof stop
+ *      prof report
+ *
+ *  On target, the timer isr calls prof_sample() with the stacked return 
+ *  address, next to contick_tick(). contick_tick() doesn't sample by 
+ *  itself, only the port knows where the interrupted pc is, e.g. on 
+ *  Cortex-M:
+ *
+ *      void SysTick_Handler(void)
+ *      {
+ *          uint32_t *sp = (uint32_t *)__get_PSP();
+ *
+ *          contick_tick();
+ *          prof_sample(sp[6]);     stacked pc
+ *      }
+ *
+ *  On Linux hosts, prof_start() samples by SIGPROF itself, every 
+ *  CONTICK_PERIOD_US of CPU time, unless built with __TEST__.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Buckets are a power of two bytes wide, so that a sample costs a 
+ *  compare, a shift and an increment. A bucket is named by the function 
+ *  holding its first address, a small one may be merged with its 
+ *  neighbour, narrow the range to split them.
+ *
+ *  A symbol map is an array sorted by address, it can be generated from 
+ *  the image, e.g.:
+ *
+ *      nm -n --defined-only app.elf | 
+ *          awk '$2 ~ /[tT]/ {printf "{0x%s, \"%s\"},\n", $1, $3}'
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __PROF_H__
+#define __PROF_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include the profiler */
+#define PROF                    0
+
+/** Number of address ranges */
+#define PROF_BUCKETS            256
+
+/** Number of hot spots reported */
+#define PROF_TOP                8
+
+/** Default range, e.g. bounds of .text. Linux hosts find it themselves */
+#define PROF_TEXT_START         0
+#define PROF_TEXT_END           0
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct ProfSym ProfSym;
+struct ProfSym
+{
+    unsigned long addr;
+    const char *name;
+};
+
+typedef struct ProfHot ProfHot;
+struct ProfHot
+{
+    unsigned long addr;         /* first address */
+    unsigned long count;        /* samples */
+    const char *name;           /* function, NULL if unknown */
+};
+
+typedef struct ProfStat ProfStat;
+struct ProfStat
+{
+    unsigned long samples;      /* taken while running */
+    unsigned long outside;      /* out of range */
+    unsigned long lo, hi;       /* range */
+    unsigned int running;
+};
+
+/* -------------------------- External variables --------------------------- */
+extern const CMD_EXT prof_ext;
+
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Clear the histogram and start sampling [lo, hi). Both 0 means the 
+ *  default range.
+ *
+ *  \return
+ *  0 on success, 1 if the range is empty.
+ */
+int prof_start(unsigned long lo, unsigned long hi);
+
+/**
+ *  \brief
+ *  Stop sampling. The histogram is kept.
+ */
+void prof_stop(void);
+
+/**
+ *  \brief
+ *  Take a sample. Called from the timer isr.
+ *
+ *  \param[in]  pc  address of the interrupted code
+ */
+void prof_sample(unsigned long pc);
+
+/**
+ *  \brief
+ *  Give the symbol map, sorted by address. NULL drops it.
+ */
+void prof_symbols(const ProfSym *syms, unsigned int n);
+
+/**
+ *  \brief
+ *  Find the hot spots, by function if a symbol map was given, otherwise 
+ *  by range.
+ *
+ *  \param[out] hot     hot spots, most samples first
+ *  \param[in]  n       room in hot
+ *
+ *  \return
+ *  Number of hot spots.
+ */
+unsigned int prof_top(ProfHot *hot, unsigned int n);
+
+void prof_stat(ProfStat *st);
+
+#if PROF
+#define CMD_TBL_PROF \
+    MK_CMD_TBL_ENTRY_EXT(           \
+        "prof", 4, 4, NULL,                            \
+        "prof\t- sampling profiler\n",                      \
+        "start [lo hi] | stop | report\n"                   \
+        "\t- 'start' clears and samples the code in hex\n"  \
+        "\t  range [lo, hi), the whole image by default\n"  \
+        "\t  'report' shows where the time goes\n",         \
+        &prof_ext                                           \
+        ),
+#else
+#define CMD_TBL_PROF
+#endif
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
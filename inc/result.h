@@ -0,0 +1,163 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+
+/**
+ *  \file   result.h
+ *  \brief  Structured results of commands, as text or CBOR.
+ *
+ *  A handler emits its result as a stream of typed items, instead of 
+ *  formatting text:
+ *
+ *      result_map(2);
+ *      result_key("port");
+ *      result_uint(3);
+ *      result_key("data");
+ *      result_bytes(buf, 4);
+ *
+ *  The session picks how it is rendered by the 'result' command. In 
+ *  text mode, the default, it reads as:
+ *
+ *      port: 3
+ *      data: 01 a0 ff 20
+ *
+ *  In CBOR mode (RFC 8949) the same calls send the encoded item, here 
+ *  a2 64 70 6f 72 74 03 64 64 61 74 61 44 01 a0 ff 20, so a host gets 
+ *  it at a fraction of the size and parses it with any CBOR library. 
+ *  Both go through conser, so capture, cache and tagged frames apply.
+ *
+ *  Containers take their number of items, maps their number of pairs, 
+ *  or RESULT_INDEF when unknown, closed then by result_end(). A map 
+ *  takes a key and a value in turn, the key usually by result_key(). 
+ *  Each item is sent right away, nothing is buffered.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  A CBOR result is a single data item, which delimits itself. In text 
+ *  mode map pairs go one per line, indented by nesting level, and the 
+ *  items of an array too. Byte strings are shown in hex.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __RESULT_H__
+#define __RESULT_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include the 'result' command, to switch sessions to CBOR */
+#define RESULT                  0
+
+/** Levels of nesting */
+#define RESULT_DEPTH            8
+
+/** Number of items of a container not known in advance */
+#define RESULT_INDEF            (~0u)
+
+/** Result modes */
+enum
+{
+    RESULT_TEXT, RESULT_CBOR
+};
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+void result_set_mode(int mode);
+int result_get_mode(void);
+
+/**
+ *  \brief
+ *  Forget containers left open, e.g. by a cancelled handler. Called by 
+ *  the shell before every command.
+ */
+void result_reset(void);
+
+void result_map(unsigned int pairs);
+void result_array(unsigned int items);
+
+/**
+ *  \brief
+ *  Close a container opened with RESULT_INDEF.
+ */
+void result_end(void);
+
+void result_uint(unsigned long v);
+void result_int(long v);
+void result_bool(int v);
+void result_bytes(const void *data, unsigned int len);
+void result_str(const char *s);
+
+/** Key of a map pair, a text string */
+#define result_key(k)           result_str(k)
+
+extern const CMD_EXT result_ext;
+
+#if RESULT
+#define CMD_TBL_RESULT \
+    MK_CMD_TBL_ENTRY_EXT(           \
+        "result", 3, 2, NULL,                          \
+        "result\t- set how results are sent\n",             \
+        "[text|cbor]\n"                                     \
+        "\t- Without arguments, print current mode\n"      \
+        "\t  'text' for people, 'cbor' for host programs,\n" \
+        "\t  see result.h\n",                               \
+        &result_ext                                         \
+        ),
+#else
+#define CMD_TBL_RESULT
+#endif
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,202 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   script.h
+ *  \brief  On-device script engine.
+ *
+ *  Scripts are typed, or sent by a host, line by line after 'script 
+ *  <name>' and up to a line holding only '.'. Every line is compiled at 
+ *  once into compact bytecode, where commands are already checked and 
+ *  split into arguments, so 'run <name>' only looks them up by name and 
+ *  dispatches them to their handlers. A registered command removed in 
+ *  between makes the script fail at that line.
+ *
+ *  Language, one statement per line:
+ *
+ *      set <v> <expr>          assign
+ *      let <v> <command>       run command, v = first number it prints
+ *      loop <expr>             repeat block expr times
+ *      while <expr>            repeat block while expr is not 0
+ *      if <expr>               run block if expr is not 0
+ *      else
+ *      end                     close loop, while or if block
+ *      <command>               any shell command, $v is replaced by v
+ *
+ *      v       variable, one letter from 'a' to 'z'
+ *      expr    <operand> [<op> <operand>]
+ *      operand variable or number, decimal or 0x hexadecimal
+ *      op      + - * / % & | == != < > <= >=
+ *
+ *  For instance:
+ *
+ *      script wait
+ *      set n 0
+ *      let r getb 3
+ *      while r != 1
+ *      let r getb 3
+ *      set n n + 1
+ *      end
+ *      echo polled $n times
+ *      .
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  A script runs inside the 'run' handler, so its loops poll 
+ *  cmd_cancelled() and they are bound by the 'run' deadline and by ^C.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __SCRIPT_H__
+#define __SCRIPT_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Include the script engine */
+#define SCRIPT                  0
+
+/* -------------------------------- Constants ------------------------------ */
+/** Bytes of bytecode for all stored scripts */
+#define SCRIPT_ARENA            512
+
+/** Number of stored scripts */
+#define SCRIPT_MAX              4
+
+/** Longest script name */
+#define SCRIPT_NAME             8
+
+/** Nesting of loop, while and if blocks */
+#define SCRIPT_DEPTH            4
+
+/** Output of a command kept by 'let' to find its number */
+#define SCRIPT_CAPTURE          32
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Start the definition of a script, replacing one of the same name.
+ *
+ *  \return
+ *  0 on success, 1 if the name is too long or there is no room.
+ */
+int script_define(const char *name);
+
+/**
+ *  \brief
+ *  True while a script is being defined.
+ */
+int script_defining(void);
+
+/**
+ *  \brief
+ *  Compile one line of the script being defined. A line holding only 
+ *  '.' ends the definition. Errors are reported on console and they 
+ *  discard the whole script, the lines up to '.' are still taken and 
+ *  not run. A script of the same name is replaced only once the new one 
+ *  compiles.
+ */
+void script_line(char *line);
+
+/**
+ *  \brief
+ *  Run a stored script. Scripts do not nest, 'run' within a script 
+ *  fails.
+ *
+ *  \return
+ *  0 on success, 1 if it is unknown, a command failed or it was cancelled.
+ */
+int script_run(const char *name);
+
+/**
+ *  \brief
+ *  Remove a stored script.
+ *
+ *  \return
+ *  0 on success, 1 if it is unknown.
+ */
+int script_delete(const char *name);
+
+/**
+ *  \brief
+ *  Capture n output bytes of a command run by 'let'. Called by conser 
+ *  module, which sends nothing to the serial channel when it returns 1.
+ */
+int script_capture(const char *s, unsigned int n);
+
+MInt do_script(const CMD_TABLE *p, MInt argc, char *argv[]);
+MInt do_run(const CMD_TABLE *p, MInt argc, char *argv[]);
+
+#if SCRIPT
+#define CMD_TBL_SCRIPT \
+    MK_CMD_TBL_ENTRY(               \
+        "script", 3, 3, do_script,                     \
+        "script\t- define, list or delete scripts\n",       \
+        "[name | del name]\n"                               \
+        "\t- Without arguments, list stored scripts\n"      \
+        "\t  With a name, the following lines up to '.' define it\n" \
+        ),                                                  \
+    MK_CMD_TBL_ENTRY(               \
+        "run", 3, 2, do_run,                           \
+        "run\t- run a stored script\n",                     \
+        "name\n"                                            \
+        "\t- Run script 'name' on device\n"                 \
+        ),
+#else
+#define CMD_TBL_SCRIPT
+#endif
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,151 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   sesrec.h
+ *  \brief  Session recorder at the shellser boundary.
+ *
+ *  Every byte received from or sent to the attached serial channel is
+ *  stored, with its tick timestamp, into a compact binary log. The log is
+ *  handed to an application supplied sink, e.g. a RAM buffer on target or
+ *  a file on host builds, and it can be fed back later by sesrep module.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Log format (all multi-byte numbers are LEB128 varints):
+ *
+ *  Header:
+ *      'S' 'R' 'E' 'C' <version> <tick period in microseconds>
+ *
+ *  Record:
+ *      <tag> <delta ticks since previous record> <payload>
+ *
+ *      tag bit 7       SESREC_TAG_TX if payload was sent by the shell,
+ *                      SESREC_TAG_RX if it was received
+ *      tag bits 0..6   payload length - 1, so 1 to 128 bytes
+ *
+ *  Consecutive bytes in the same direction and in the same tick are
+ *  packed into one record, so an idle echo costs 3 bytes per keystroke
+ *  and a full output line costs 2 bytes of overhead.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __SESREC_H__
+#define __SESREC_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Include the session recorder */
+#define SESREC                  0
+
+#if SESREC
+#define SESREC_RX(c)            sesrec_rx(c)
+#define SESREC_TX(s, n)         sesrec_tx((s), (n))
+#else
+#define SESREC_RX(c)
+#define SESREC_TX(s, n)
+#endif
+
+/* -------------------------------- Constants ------------------------------ */
+/** Size of staging buffer, maximum payload of one record */
+#define SESREC_CHUNK            128
+
+#define SESREC_VERSION          1
+
+/** Direction bit of record tag */
+#define SESREC_TAG_RX           0x00
+#define SESREC_TAG_TX           0x80
+#define SESREC_TAG_LEN          0x7F
+
+/* ------------------------------- Data types ------------------------------ */
+/**
+ *  \brief
+ *  Receives every encoded chunk of the log.
+ */
+typedef void (*SesRecSink)(const unsigned char *p, unsigned int n);
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Start a new recording. The log header is written at once.
+ *
+ *  \param[in]  sink    log output
+ */
+void sesrec_start(SesRecSink sink);
+
+/**
+ *  \brief
+ *  Flush the pending record and stop recording.
+ */
+void sesrec_stop(void);
+
+/**
+ *  \brief
+ *  Flush the pending record to the sink.
+ */
+void sesrec_flush(void);
+
+/**
+ *  \brief
+ *  Record one received byte.
+ */
+void sesrec_rx(char c);
+
+/**
+ *  \brief
+ *  Record n sent bytes.
+ */
+void sesrec_tx(const char *s, unsigned int n);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
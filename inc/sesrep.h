@@ -0,0 +1,159 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   sesrep.h
+ *  \brief  Replay driver for logs written by sesrec module.
+ *
+ *  The RX side of the log is fed back to the shell through the conser 
+ *  functions (SESREP_PLATFORM) and everything the shell sends is compared 
+ *  against the recorded TX side. Host builds only.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  A received record is released only after every TX byte recorded before 
+ *  it has been sent by the shell, so the replay follows the same 
+ *  request/response order of the original session regardless of speed.
+ *
+ *  The shell must be initialized before sesrep_open(), so recordings are 
+ *  expected to start after simshell_init() has printed its first prompt.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __SESREP_H__
+#define __SESREP_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "mytypes.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Replay modes */
+enum
+{
+    SESREP_FAST,        /* feed RX side as fast as the shell reads it */
+    SESREP_TIMED        /* keep the original timing of RX side */
+};
+
+/** Return codes of sesrep_open() */
+enum
+{
+    SESREP_OK, SESREP_BAD_HEADER, SESREP_BAD_RECORD
+};
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct SesRepStat SesRepStat;
+struct SesRepStat
+{
+    unsigned long rx;           /* bytes fed to the shell */
+    unsigned long tx;           /* bytes sent by the shell */
+    unsigned long expected;     /* TX bytes in the log */
+    unsigned long mismatches;   /* TX bytes that differ from the log */
+    unsigned long first;        /* TX offset of first mismatch */
+    unsigned long usec;         /* elapsed time since sesrep_open() */
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Check the log and start a replay.
+ *
+ *  \param[in]  log     whole log, as written by sesrec module
+ *  \param[in]  len     log length in bytes
+ *  \param[in]  mode    SESREP_FAST or SESREP_TIMED
+ *
+ *  \return
+ *  SESREP_OK on success, otherwise the log is rejected.
+ */
+int sesrep_open(const unsigned char *log, unsigned long len, int mode);
+
+/**
+ *  \brief
+ *  Same convention as conser_tstc().
+ *
+ *  \return
+ *  0 - a received byte is ready
+ *  1 - nothing to read yet
+ */
+MUInt sesrep_tstc(void);
+
+/**
+ *  \brief
+ *  Return the next received byte or 0xFF if there is none.
+ */
+MUInt sesrep_getc(void);
+
+/**
+ *  \brief
+ *  Compare bytes sent by the shell against the log.
+ */
+void sesrep_putc(const char c);
+void sesrep_puts(const char *s);
+
+/**
+ *  \brief
+ *  True when all the received bytes were consumed.
+ */
+int sesrep_done(void);
+
+/**
+ *  \brief
+ *  Get the replay figures. Throughput is (rx + tx) / usec.
+ *
+ *  \return
+ *  0 if the TX side matched the log, otherwise 1.
+ */
+int sesrep_result(SesRepStat *st);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
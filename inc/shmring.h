@@ -0,0 +1,144 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   shmring.h
+ *  \brief  Shell transport over a pair of rings in POSIX shared memory.
+ *
+ *  The shell creates a named shared memory object holding two single 
+ *  producer, single consumer rings, one for each direction. Local tools 
+ *  and test harnesses attach to it by name and talk to the shell with no 
+ *  system calls on the data path, only loads and stores. Host builds 
+ *  only.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Shared memory layout, indexes grow forever and are masked on access:
+ *
+ *      magic, size         SHMRING_MAGIC and SHMRING_SIZE of the creator
+ *      peers               tools attached
+ *      in                  ring from tool to shell
+ *      out                 ring from shell to tool
+ *
+ *  Every ring holds its head, written by the producer only, and its tail, 
+ *  written by the consumer only, on separate cache lines.
+ *
+ *  peers only drops when a tool calls shmring_close(). A tool that dies 
+ *  without it leaves the shell attached, so once the output ring is full 
+ *  the shell waits for room forever. Restart the shell, or attach again 
+ *  and read the ring, to recover.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __SHMRING_H__
+#define __SHMRING_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "transport.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include the shared memory transport */
+#define SHMRING                 0
+
+/** Size of every ring. It must be a power of 2 */
+#define SHMRING_SIZE            4096
+
+#define SHMRING_MAGIC           0x53484D52UL    /* "SHMR" */
+
+/** Sides of the link */
+enum
+{
+    SHMRING_SHELL, SHMRING_TOOL
+};
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct ShmLink ShmLink;
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Open a link. The shell side creates the shared memory object, empty, 
+ *  and the tool side attaches to an existing one.
+ *
+ *  \param[in]  name    shared memory object name, e.g. "/simshell"
+ *  \param[in]  side    SHMRING_SHELL or SHMRING_TOOL
+ *
+ *  \return
+ *  The link or NULL on error.
+ */
+ShmLink *shmring_open(const char *name, int side);
+
+/**
+ *  \brief
+ *  Close a link. The shell side also removes the object name.
+ */
+void shmring_close(ShmLink *link);
+
+/**
+ *  \brief
+ *  Transport over the link, to bind with conser_bind() on shell side.
+ */
+const Transport *shmring_transport(ShmLink *link);
+
+/**
+ *  \brief
+ *  Transport operations, also used straight by tools. They never block.
+ */
+unsigned int shmring_read(void *link, void *buf, unsigned int len);
+unsigned int shmring_write(void *link, const void *buf, unsigned int len);
+int shmring_poll(void *link);
+int shmring_attached(void *link);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -48,6 +48,8 @@
 #define __SIMSHELL_H__
 
 /* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
 /* ---------------------- External C language linkage ---------------------- */
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +63,51 @@ extern "C" {
 #define CONFIG_CMD_TOUT_MIN     1
 #define CONFIG_CMD_TIME         3 /* seconds */
 
+/** Define the size of console buffer */
+#define CBSIZE                  32
+
+/** Deepest nesting of handlers running other commands, e.g. scripts */
+#define SIMSHELL_DEPTH          4
+
+/** Include raw line mode, for host clients that edit lines locally */
+#define RAWLINE                 1
+
+/** 
+ *  Split the line into arguments and look up the command while it is 
+ *  being typed, so that Enter dispatches at once. An unknown command 
+ *  rings the bell as soon as its name is finished.
+ */
+#define INCPARSE                1
+
+/** 
+ *  Include simshell_slice(), which runs the shell within a budget of 
+ *  time or output, see CMD_MORE in command.h
+ */
+#define BUDGET                  0
+
+/** Time base of budgets, e.g. a cycle counter. Ticks by default */
+#define SIMSHELL_NOW()          contick_now()
+
+#if BUDGET
+/** Console output so far, counted by conser */
+extern unsigned long simshell_tx;
+#define SIMSHELL_TX(n)          (simshell_tx += (n))
+#else
+#define SIMSHELL_TX(n)
+#endif
+
+/** Status of simshell_slice() */
+enum
+{
+    SIMSHELL_IDLE, SIMSHELL_MORE
+};
+
+/** Line modes */
+enum
+{
+    LINE_EDIT, LINE_RAW, LINE_TAGGED
+};
+
 /* ------------------------------- Data types ------------------------------ */
 /* -------------------------- External variables --------------------------- */
 /* -------------------------- Function prototypes -------------------------- */
@@ -78,6 +125,50 @@ void simshell_init(void);
  */
 int simshell_process(int c);
 
+/**
+ *  \brief
+ *  Run the shell for a while, e.g. from a cooperative scheduler. It 
+ *  handles input, dispatches lines and resumes long handlers until 
+ *  there is nothing to do or the budget is spent. A budget of 0 is 
+ *  unlimited.
+ *
+ *  \param[in]  ticks   budget of time, in SIMSHELL_NOW() units
+ *  \param[in]  bytes   budget of console output
+ *
+ *  \return
+ *  SIMSHELL_MORE if work is pending, so it should be called again soon, 
+ *  otherwise SIMSHELL_IDLE.
+ */
+int simshell_slice(unsigned long ticks, unsigned int bytes);
+
+/**
+ *  \brief
+ *  Run a command already looked up and split into arguments, the same 
+ *  way as a line typed on console, so a group goes down to the command 
+ *  named by the arguments. Used by handlers that run other commands.
+ *
+ *  \return
+ *  0 - command executed
+ *  -1 - not executed (too many or bad args) or it failed
+ */
+int simshell_exec(const CMD_TABLE *cmdtp, int argc, char *argv[]);
+
+/**
+ *  \brief
+ *  Set line mode. In LINE_RAW mode the shell does not echo input, expand 
+ *  TABs or redraw the line being edited. Lines are expected finished, as 
+ *  sent by a host client, and the prompt only tells the end of command 
+ *  output. LINE_TAGGED is raw mode without prompt, where every line 
+ *  carries a tag, see tagreq.h.
+ */
+void simshell_set_linemode(int mode);
+
+/**
+ *  \brief
+ *  Get line mode.
+ */
+int simshell_get_linemode(void);
+
 /* -------------------- External C language linkage end -------------------- */
 #ifdef __cplusplus
 }
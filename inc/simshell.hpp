@@ -0,0 +1,653 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+
+/**
+ *  \file   simshell.hpp
+ *  \brief  Header-only C++17 front end of the shell.
+ *
+ *  The limits and options that the C core takes from global #defines 
+ *  are members of a configuration class, and the serial line is a class 
+ *  held by the shell, so its calls are inlined. The command table is a 
+ *  constexpr array, sorted and checked when compiled: names must be 
+ *  unique, their abbreviations unambiguous and their argument counts 
+ *  within the limit. Shells of different configurations and transports 
+ *  can live in the same binary.
+ *
+ *      struct Uart
+ *      {
+ *          unsigned tstc();        0 when a character is waiting
+ *          char getc();
+ *          void putc(char c);
+ *      };
+ *
+ *      struct Small : simshell::Defaults
+ *      {
+ *          static constexpr unsigned cbsize = 24;
+ *
+ *          template <class Sh>
+ *          static constexpr auto commands()
+ *          {
+ *              return simshell::make_table<Sh>(
+ *                  simshell::help_cmd<Sh>(),
+ *                  simshell::echo_cmd<Sh>(),
+ *                  simshell::Cmd<Sh>{"led", 3, 2, do_led<Sh>,
+ *                                    "led\t- Turn led on or off\n", 
+ *                                    nullptr});
+ *          }
+ *      };
+ *
+ *      simshell::Shell<Uart, Small> shell;
+ *
+ *      shell.init();
+ *      for (;;)
+ *      {
+ *          shell.process();
+ *      }
+ *
+ *  Handlers take the shell, to print through it:
+ *
+ *      template <class Sh>
+ *      int do_led(Sh &sh, int argc, char *argv[])
+ *      {
+ *          ...
+ *          sh.puts("on\n");
+ *          return 0;
+ *      }
+ *
+ *  Lines are edited and commands looked up and run as the C core does, 
+ *  with the same messages. The C core is not used, so its extensions 
+ *  (groups, typed arguments, type-ahead, scripts, ...) are not there.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Lookup is a binary search of the sorted table. With abbreviations a 
+ *  line matches a command when it starts with the first lmin characters 
+ *  of its name, as find_cmd() does. No two commands may share those, so 
+ *  there is one match at most and the search stays ordered.
+ *
+ *  A TAB is taken as a space, instead of being expanded on console.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __SIMSHELL_HPP__
+#define __SIMSHELL_HPP__
+
+/* ----------------------------- Include files ----------------------------- */
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace simshell
+{
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/* ------------------------------- Data types ------------------------------ */
+/** 
+ *  Default configuration, the same as the C core. A product derives 
+ *  from it, overrides what it needs and adds commands<Sh>().
+ */
+struct Defaults
+{
+    static constexpr unsigned cbsize = 32;          /* CBSIZE */
+    static constexpr unsigned maxargs = 11;         /* MAXARGS */
+    static constexpr bool delete_char = true;       /* DELETE_CHAR */
+    static constexpr bool print_formats = true;     /* PRINT_FORMATS */
+    static constexpr bool longhelp = true;          /* LONGHELP */
+    static constexpr bool abbreviated = true;       /* ABBREVIATED */
+    static constexpr const char *prompt = ">>";
+};
+
+/** Command table entry, as CMD_TABLE */
+template <class Sh>
+struct Cmd
+{
+    const char *name;
+    unsigned lmin;                  /* abbreviated length */
+    unsigned maxargs;
+    int (*run)(Sh &sh, int argc, char *argv[]);
+    const char *usage;
+    const char *help;               /* long help, or nullptr */
+};
+
+/* -------------------------- Function prototypes -------------------------- */
+namespace detail
+{
+
+constexpr unsigned
+length(const char *s)
+{
+    unsigned n = 0;
+
+    while (s[n] != '\0')
+    {
+        ++n;
+    }
+    return n;
+}
+
+/** As strncmp() */
+constexpr int
+compare(const char *a, const char *b, unsigned n)
+{
+    for (; n > 0; --n, ++a, ++b)
+    {
+        if (*a != *b || *a == '\0')
+        {
+            return (unsigned char)*a - (unsigned char)*b;
+        }
+    }
+    return 0;
+}
+
+template <class Sh, std::size_t N>
+constexpr std::array<Cmd<Sh>, N>
+sort(std::array<Cmd<Sh>, N> t)
+{
+    for (std::size_t i = 1; i < N; ++i)
+    {
+        for (std::size_t j = i; j > 0 &&
+             compare(t[j].name, t[j - 1].name, ~0u) < 0; --j)
+        {
+            Cmd<Sh> c = t[j];
+
+            t[j] = t[j - 1];
+            t[j - 1] = c;
+        }
+    }
+    return t;
+}
+
+/** Every entry has a name, a handler and lmin within the name */
+template <class Sh, std::size_t N>
+constexpr bool
+entries_ok(const std::array<Cmd<Sh>, N> &t)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (t[i].name == nullptr || t[i].run == nullptr || 
+            t[i].lmin == 0 || t[i].lmin > length(t[i].name))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Sh, std::size_t N>
+constexpr bool
+args_ok(const std::array<Cmd<Sh>, N> &t, unsigned maxargs)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (t[i].maxargs == 0 || t[i].maxargs > maxargs)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** No line matches two entries */
+template <class Sh, std::size_t N>
+constexpr bool
+unambiguous(const std::array<Cmd<Sh>, N> &t, bool abbreviated)
+{
+    for (std::size_t i = 1; i < N; ++i)
+    {
+        unsigned n = t[i].lmin < t[i - 1].lmin ? t[i].lmin : t[i - 1].lmin;
+
+        if (compare(t[i].name, t[i - 1].name, abbreviated ? n : ~0u) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+/**
+ *  \brief
+ *  Build a command table, sorted by name.
+ */
+template <class Sh, class... C>
+constexpr std::array<Cmd<Sh>, sizeof...(C)>
+make_table(const C &... c)
+{
+    return detail::sort<Sh, sizeof...(C)>({{c...}});
+}
+
+/* -------------------------------- Shell ---------------------------------- */
+template <class Transport, class Config = Defaults>
+class Shell
+{
+public:
+    using Command = Cmd<Shell>;
+    using Configuration = Config;
+
+    static constexpr auto table = Config::template commands<Shell>();
+
+    static_assert(Config::cbsize >= 4, "console buffer too small");
+    static_assert(Config::maxargs >= 1, "no arguments");
+    static_assert(table.size() > 0, "no commands");
+    static_assert(detail::entries_ok(table),
+                  "command without name or handler, or bad lmin");
+    static_assert(detail::args_ok(table, Config::maxargs),
+                  "command maxargs out of 1..Config::maxargs");
+    static_assert(detail::unambiguous(table, Config::abbreviated),
+                  "two commands match the same line");
+
+    template <class... A>
+    explicit Shell(A &&... a) : io(std::forward<A>(a)...), n(0)
+    {
+    }
+
+    Transport &
+    transport()
+    {
+        return io;
+    }
+
+    void
+    putc(char c)
+    {
+        io.putc(c);
+    }
+
+    void
+    puts(const char *s)
+    {
+        while (*s != '\0')
+        {
+            io.putc(*s++);
+        }
+    }
+
+    void
+    putu(unsigned v)
+    {
+        char d[10];
+        unsigned i = 0;
+
+        do
+        {
+            d[i++] = (char)('0' + v % 10);
+        }
+        while ((v /= 10) != 0);
+        while (i > 0)
+        {
+            io.putc(d[--i]);
+        }
+    }
+
+    /** Print the prompt, as simshell_init() */
+    void
+    init()
+    {
+        prompt();
+    }
+
+    /** Take a character, if any, as simshell_process() */
+    void
+    process()
+    {
+        if (io.tstc() == 0)
+        {
+            input(io.getc());
+        }
+    }
+
+    /**
+     *  \brief
+     *  Edit the line with a character, and run it on Enter.
+     */
+    void
+    input(char c)
+    {
+        switch (c)
+        {
+            case '\r':
+            case '\n':
+                buf[n] = '\0';
+                puts("\r\n");
+                run(buf);
+                prompt();
+                break;
+            case 0x03:                                  /* ^C */
+                puts("\r\n");
+                prompt();
+                break;
+            case 0x15:                                  /* ^U */
+                while (Config::delete_char && n > 0)
+                {
+                    erase();
+                }
+                break;
+            case 0x17:                                  /* ^W */
+                if (Config::delete_char)
+                {
+                    erase();
+                    while (n > 0 && buf[n - 1] != ' ')
+                    {
+                        erase();
+                    }
+                }
+                break;
+            case 0x08:                                  /* backspace */
+            case 0x7F:
+                if (Config::delete_char)
+                {
+                    erase();
+                }
+                break;
+            default:
+                if (n < Config::cbsize - 2)
+                {
+                    c = c == '\t' ? ' ' : c;
+                    buf[n++] = c;
+                    io.putc(c);
+                }
+                else
+                {
+                    io.putc('\a');
+                }
+                break;
+        }
+    }
+
+    /**
+     *  \brief
+     *  Find the command of a name, as find_cmd().
+     *
+     *  \return
+     *  Table entry, or nullptr if not found.
+     */
+    static constexpr const Command *
+    find(const char *name)
+    {
+        std::size_t lo = 0, hi = table.size(), mid = 0;
+        int r = 0;
+
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            r = detail::compare(name, table[mid].name, Config::abbreviated ?
+                                table[mid].lmin : ~0u);
+            if (r == 0)
+            {
+                return &table[mid];
+            }
+            if (r < 0)
+            {
+                hi = mid;
+            }
+            else
+            {
+                lo = mid + 1;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     *  \brief
+     *  Split a line into arguments and run its command.
+     *
+     *  \return
+     *  Return code of handler, or -1 if the line is empty, the command 
+     *  unknown or the arguments too many.
+     */
+    int
+    run(char *line)
+    {
+        char *argv[Config::maxargs + 1];
+        const Command *cmd;
+        int argc;
+
+        if ((argc = parse(line, argv)) <= 0)
+        {
+            return -1;
+        }
+        if ((cmd = find(argv[0])) == nullptr)
+        {
+            if (Config::print_formats)
+            {
+                puts("Unknown command '");
+                puts(argv[0]);
+                puts("' - try 'help'\n");
+            }
+            else
+            {
+                puts("Unknown command - try 'help'\n");
+            }
+            return -1;
+        }
+        if ((unsigned)argc > cmd->maxargs)
+        {
+            puts("Usage:\n");
+            puts(cmd->usage);
+            putc('\n');
+            return -1;
+        }
+        return cmd->run(*this, argc, argv);
+    }
+
+private:
+    Transport io;
+    char buf[Config::cbsize];
+    unsigned n;
+
+    void
+    prompt()
+    {
+        n = 0;
+        puts(Config::prompt);
+    }
+
+    void
+    erase()
+    {
+        if (n == 0)
+        {
+            io.putc('\a');
+            return;
+        }
+        --n;
+        puts("\b \b");
+    }
+
+    int
+    parse(char *line, char *argv[])
+    {
+        unsigned nargs = 0;
+
+        while (nargs < Config::maxargs)
+        {
+            while (*line == ' ' || *line == '\t')
+            {
+                ++line;
+            }
+            if (*line == '\0')
+            {
+                break;
+            }
+            argv[nargs++] = line;
+            while (*line != '\0' && *line != ' ' && *line != '\t')
+            {
+                ++line;
+            }
+            if (*line == '\0')
+            {
+                break;
+            }
+            *line++ = '\0';
+        }
+        argv[nargs] = nullptr;
+
+        if (nargs == Config::maxargs && *line != '\0')
+        {
+            if (Config::print_formats)
+            {
+                puts("** Too many args (max. ");
+                putu(Config::maxargs);
+                puts(") **\n");
+            }
+            else
+            {
+                puts("** Too many args **\n");
+            }
+            return -1;
+        }
+        return (int)nargs;
+    }
+};
+
+/* --------------------------- Built-in commands --------------------------- */
+/** As 'echo', '\c' at the end of an argument drops the newline */
+template <class Sh>
+int
+echo(Sh &sh, int argc, char *argv[])
+{
+    bool nl = true;
+    const char *p;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i > 1)
+        {
+            sh.putc(' ');
+        }
+        for (p = argv[i]; *p != '\0'; ++p)
+        {
+            if (p[0] == '\\' && p[1] == 'c')
+            {
+                nl = false;
+                ++p;
+            }
+            else
+            {
+                sh.putc(*p);
+            }
+        }
+    }
+    if (nl)
+    {
+        sh.putc('\n');
+    }
+    return 0;
+}
+
+/** As 'help', the usage of every command or the long help of some */
+template <class Sh>
+int
+help(Sh &sh, int argc, char *argv[])
+{
+    using Config = typename Sh::Configuration;
+    const typename Sh::Command *cmd;
+    int rc = 0;
+
+    if (argc == 1)
+    {
+        for (const auto &c : Sh::table)
+        {
+            sh.puts(c.usage);
+        }
+        return 0;
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((cmd = Sh::find(argv[i])) == nullptr)
+        {
+            sh.puts("Unknown command '");
+            sh.puts(argv[i]);
+            sh.puts("' - try 'help' without arguments for list of all "
+                    "known commands\n\n");
+            rc = 1;
+        }
+        else if (Config::longhelp)
+        {
+            sh.puts(cmd->name);
+            sh.putc(' ');
+            sh.puts(cmd->help ? cmd->help : "- No help available.\n");
+            sh.putc('\n');
+            rc = cmd->help ? rc : 1;
+        }
+        else
+        {
+            sh.puts(cmd->usage);
+        }
+    }
+    return rc;
+}
+
+template <class Sh>
+constexpr Cmd<Sh>
+echo_cmd()
+{
+    return {"echo", 4, Sh::Configuration::maxargs, echo<Sh>,
+            "echo\t- Echo args to console\n",
+            "[args..]\n"
+            "\t- Echo args to console; \\c suppresses newline\n"};
+}
+
+template <class Sh>
+constexpr Cmd<Sh>
+help_cmd()
+{
+    return {"help", 1, Sh::Configuration::maxargs, help<Sh>,
+            "help\t- Print online help\n",
+            "[command ...]\n"
+            "\t- Show help information for command\n"
+            "\t  Help prints online help for the monitor commands.\n\n"
+            "\t  Without arguments, it prints a short usage message for all "
+            "commands.\n\n"
+            "\t  To get detailed help information for specific commands you "
+            "can type\n"
+            "\t  'help' with one or more command names as arguments.\n"};
+}
+
+}
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,191 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   simtrace.h
+ *  \brief  Compile-time tracepoints of command shell.
+ *
+ *  Every tracepoint stores an event with its timestamp into an in-memory 
+ *  ring. The ring is written by the shell only and it never blocks, so 
+ *  other contexts (a debugger, another task, 'trace' command) can read it 
+ *  at any time. When SIMTRACE is 0 the tracepoints compile to nothing.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* --------------------------------- Module -------------------------------- */
+#ifndef __SIMTRACE_H__
+#define __SIMTRACE_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include <stdint.h>
+#include <string.h>
+#include "contick.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Include the tracepoints */
+#define SIMTRACE                0
+
+/** 
+ * Timestamp of events. Replace it by a cycle counter when the target has 
+ * one, e.g. DWT->CYCCNT on Cortex-M.
+ */
+#define SIMTRACE_TIMESTAMP()    contick_now()
+
+/** 
+ * Keep the compiler from moving the stores of an event past the 
+ * increment of simtrace_head, which publishes it.
+ */
+#if defined(__GNUC__)
+#define SIMTRACE_BARRIER()      __asm__ volatile ("" ::: "memory")
+#else
+#define SIMTRACE_BARRIER()
+#endif
+
+#if SIMTRACE
+#define SIMTRACE_EVT(e, a) \
+    do \
+    { \
+        SimTraceEvt *evt_ = &simtrace_ring[simtrace_head & \
+                                           (SIMTRACE_SIZE - 1)]; \
+        evt_->ts = SIMTRACE_TIMESTAMP(); \
+        evt_->arg = (uintptr_t)(a); \
+        evt_->ev = (e); \
+        SIMTRACE_BARRIER(); \
+        ++simtrace_head; \
+    } while (0)
+
+/* 
+ * Command events keep a copy of the name, the entry may be gone by the 
+ * time the ring is dumped, e.g. a module was unloaded.
+ */
+#define SIMTRACE_CMD(e, c) \
+    do \
+    { \
+        SimTraceEvt *evt_ = &simtrace_ring[simtrace_head & \
+                                           (SIMTRACE_SIZE - 1)]; \
+        evt_->ts = SIMTRACE_TIMESTAMP(); \
+        evt_->arg = 0; \
+        strncpy(evt_->name, (c)->name, SIMTRACE_NAME); \
+        evt_->ev = (e); \
+        SIMTRACE_BARRIER(); \
+        ++simtrace_head; \
+    } while (0)
+#else
+#define SIMTRACE_EVT(e, a)
+#define SIMTRACE_CMD(e, c)
+#endif
+
+/* -------------------------------- Constants ------------------------------ */
+/** Number of events in the ring. It must be a power of 2 */
+#define SIMTRACE_SIZE           32
+
+/** Characters of the command name kept by an event, not NUL terminated */
+#define SIMTRACE_NAME           8
+
+/** Events */
+enum
+{
+    TRC_RX,             /* char received, arg: char */
+    TRC_LINE,           /* line complete, arg: line length */
+    TRC_PARSE,          /* parse done, arg: argc */
+    TRC_HIT,            /* lookup hit, name: command */
+    TRC_MISS,           /* lookup miss */
+    TRC_ENTER,          /* handler enter, name: command */
+    TRC_EXIT,           /* handler exit, arg: return code */
+    TRC_PROMPT,         /* prompt printed */
+
+    TRC_NUM_EVENTS
+};
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct SimTraceEvt SimTraceEvt;
+struct SimTraceEvt
+{
+    unsigned long ts;
+    uintptr_t arg;
+    char name[SIMTRACE_NAME];
+    unsigned char ev;
+};
+
+/* -------------------------- External variables --------------------------- */
+/** 
+ * Event ring and the number of events written so far. simtrace_head is 
+ * incremented after the event is stored.
+ */
+extern SimTraceEvt simtrace_ring[SIMTRACE_SIZE];
+extern volatile unsigned long simtrace_head;
+
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Discard every stored event.
+ */
+void simtrace_clear(void);
+
+/**
+ *  \brief
+ *  Copy the latest stored events, oldest first and no more than max, to 
+ *  evts. At most SIMTRACE_SIZE - 1 are kept, the slot of the oldest one 
+ *  is where the next event goes.
+ *
+ *  \return
+ *  Number of copied events.
+ */
+unsigned int simtrace_snapshot(SimTraceEvt *evts, unsigned int max);
+
+/**
+ *  \brief
+ *  Name of event.
+ */
+const char *simtrace_name(unsigned char ev);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,135 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   stackhw.h
+ *  \brief  Stack high-water mark of every command.
+ *
+ *  Before calling a handler the shell paints the stack region below its 
+ *  own frame with a known pattern, and once the handler returns it looks 
+ *  for the deepest byte that was overwritten. The worst case of every 
+ *  command is kept and shown by 'stackstat', so the shell task stack can 
+ *  be sized from data.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The stack must grow downwards and STACKHW_DEPTH bytes below the frame 
+ *  of the shell must be inside the shell task stack. Isrs running on the 
+ *  same stack can only make the figures larger. A figure equal to 
+ *  STACKHW_DEPTH means the handler went beyond the painted region.
+ *
+ *  Only commands typed on console are measured, their figures include 
+ *  the commands they run, e.g. by scripts.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __STACKHW_H__
+#define __STACKHW_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "command.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/** Keep a function out of line, so it has a frame of its own */
+#define STACKHW_NOINLINE        __attribute__((noinline))
+
+/* -------------------------------- Constants ------------------------------ */
+/** Include the stack instrumentation */
+#define STACKHW                 0
+
+/** Bytes painted below the frame of the shell */
+#define STACKHW_DEPTH           1024
+
+/** Paint pattern */
+#define STACKHW_PATTERN         0xA5
+
+/** Number of commands recorded */
+#define STACKHW_MAX             16
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Paint the stack below the caller's frame. Call it right before the 
+ *  handler, from the same function.
+ */
+STACKHW_NOINLINE void stackhw_paint(void);
+
+/**
+ *  \brief
+ *  Measure the stack used by the handler since stackhw_paint() and keep 
+ *  it if it is the worst case of the command.
+ *
+ *  \return
+ *  Bytes used.
+ */
+STACKHW_NOINLINE unsigned int stackhw_measure(const CMD_TABLE *cmdtp);
+
+MInt do_stackstat(const CMD_TABLE *p, MInt argc, char *argv[]);
+
+#if STACKHW
+#define CMD_TBL_STACKSTAT \
+    MK_CMD_TBL_ENTRY(               \
+        "stackstat", 5, 2, do_stackstat,               \
+        "stackstat\t- show stack used by commands\n",       \
+        "[clear]\n"                                         \
+        "\t- Without arguments, print the worst stack use of\n" \
+        "\t  every command run so far, in bytes\n"          \
+        "\t  'clear' forgets them\n"                        \
+        ),
+#else
+#define CMD_TBL_STACKSTAT
+#endif
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
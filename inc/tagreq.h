@@ -0,0 +1,161 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   tagreq.h
+ *  \brief  Tagged requests, for hosts that pipeline commands.
+ *
+ *  In tagged line mode ('line tag') every request line starts with a 
+ *  decimal tag, from 1 to 65535, and the shell prints no prompt, so a 
+ *  host can keep many requests in flight without waiting for each one. 
+ *  Every response is framed with its tag and completion status:
+ *
+ *      -> 7 getb 3
+ *      -> 8 stat
+ *      <- @7
+ *      <- 1
+ *      <- !7 0
+ *      <- @8
+ *      <- ...
+ *      <- !8 0
+ *
+ *  A line '@<tag>' tells that the following output belongs to that 
+ *  request, '!<tag> <status>' completes it, status 0 on success and -1 
+ *  if it failed. Output outside an '@' ... '!' frame, e.g. log records, 
+ *  belongs to no request. A line without valid tag is answered '!0 -1'.
+ *
+ *  A handler may complete later, out of order, e.g. once a slow 
+ *  operation ends:
+ *
+ *      tag = tagreq_defer();           in the handler, then return 0
+ *      ...
+ *      if (tagreq_resume(tag) == 0)    later, from the main loop
+ *      {
+ *          myprintf(0, "...");
+ *          tagreq_done(tag, 0);
+ *      }
+ *
+ *  Meanwhile the shell goes on with the following requests. A deferred 
+ *  request is resumed only while no other one is open, otherwise its 
+ *  frame would be printed inside the frame of the open request. A request 
+ *  is open from its line until its handler returns, including the turns 
+ *  of a handler returning CMD_MORE.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Requests are queued by the type-ahead queue, if included, or by the 
+ *  serial channel while a handler runs.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __TAGREQ_H__
+#define __TAGREQ_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include tagged line mode */
+#define TAGREQ                  0
+
+/** Largest tag */
+#define TAGREQ_MAX              65535U
+
+/* ------------------------------- Data types ------------------------------ */
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Take the tag off a request line and open its response.
+ *
+ *  \param[in,out]  line    request, the command on return
+ *
+ *  \return
+ *  0 on success, 1 if the tag is missing or bad, already answered.
+ */
+int tagreq_begin(char **line);
+
+/**
+ *  \brief
+ *  Complete the current request, unless its handler deferred it.
+ *
+ *  \param[in]  rc  0 on success, < 0 if it failed
+ */
+void tagreq_end(int rc);
+
+/**
+ *  \brief
+ *  Called by a handler to complete its request later.
+ *
+ *  \return
+ *  Tag to complete, 0 if the shell is not in tagged mode and the handler 
+ *  must complete at once.
+ */
+unsigned int tagreq_defer(void);
+
+/**
+ *  \brief
+ *  Open the response of a deferred request again, before further output.
+ *
+ *  \return
+ *  0 on success, 1 if another request is open, nothing is printed then 
+ *  and the caller tries again later.
+ */
+int tagreq_resume(unsigned int tag);
+
+/**
+ *  \brief
+ *  Complete a deferred request.
+ */
+void tagreq_done(unsigned int tag, int rc);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
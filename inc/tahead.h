@@ -0,0 +1,174 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   tahead.h
+ *  \brief  Type-ahead queue of complete command lines.
+ *
+ *  While a command handler is running nobody reads the attached serial 
+ *  channel, so bursts and pasted lines pile up in the underlying queue 
+ *  until it overflows. Long running handlers call tahead_drain() now and 
+ *  then to move that input into a fixed arena as complete lines, each one 
+ *  behind a length header. Once the handler returns, the shell dispatches 
+ *  the queued lines in order, one per simshell_process() call, filling 
+ *  the arena again with input still arriving, and then goes on with 
+ *  interactive editing.
+ *
+ *  Input is left in the underlying queue once the arena might not take 
+ *  it, so a full arena holds the host back by flow control, see 
+ *  flowctl.h, instead of dropping lines.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The queue is filled either by tahead_drain() while the shell is busy 
+ *  or by the shell itself while it dispatches queued lines, and it is 
+ *  emptied by the shell only when it is not busy. Both read the console 
+ *  by conser, which is not isr-safe, so they run in the main context 
+ *  only and producer and consumer never run at the same time.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __TAHEAD_H__
+#define __TAHEAD_H__
+
+/* ----------------------------- Include files ----------------------------- */
+#include "simshell.h"
+
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Include the type-ahead queue */
+#define TAHEAD                  1
+
+/** Size of arena in bytes. It must be a power of 2 */
+#define TAHEAD_SIZE             256
+
+/** Longest line, it matches the console buffer of shell */
+#define TAHEAD_LINE             (CBSIZE - 2)
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct TAheadStat TAheadStat;
+struct TAheadStat
+{
+    unsigned long lines;        /* queued lines */
+    unsigned long overflows;    /* lines dropped because arena was full */
+    unsigned long toolong;      /* lines dropped because they were too long */
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Discard every queued line and clear the counters.
+ */
+void tahead_init(void);
+
+/**
+ *  \brief
+ *  Mark the shell as busy or idle. The shell calls it around handlers.
+ */
+void tahead_busy(int busy);
+
+/**
+ *  \brief
+ *  Move available input bytes into the queue, only while the shell is 
+ *  busy. Call it from long running handlers, never from an isr.
+ */
+void tahead_drain(void);
+
+/**
+ *  \brief
+ *  Move available input bytes into the queue, as long as there is room 
+ *  for them.
+ */
+void tahead_fill(void);
+
+/**
+ *  \brief
+ *  Store one input byte. '\r' and '\n' complete a line, backspace and ^U 
+ *  edit the line in progress and ^C discards everything.
+ */
+void tahead_put(char c);
+
+/**
+ *  \brief
+ *  True if there are queued lines or a line in progress.
+ */
+int tahead_pending(void);
+
+/**
+ *  \brief
+ *  Get the oldest complete line.
+ *
+ *  \param[out] line    '\0' terminated line, TAHEAD_LINE + 1 bytes
+ *
+ *  \return
+ *  Line length or -1 if there is no complete line.
+ */
+int tahead_get(char *line);
+
+/**
+ *  \brief
+ *  Take the line in progress, without its end of line.
+ *
+ *  \return
+ *  Line length, 0 if there is none.
+ */
+int tahead_partial(char *line);
+
+/**
+ *  \brief
+ *  Get the counters.
+ */
+void tahead_stat(TAheadStat *st);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,106 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   transport.h
+ *  \brief  Pluggable transport of the shell console.
+ *
+ *  By default the console is bound at link time to the platform serial 
+ *  channel. A transport is a table of bulk operations over any other kind 
+ *  of channel, e.g. the shared memory rings of shmring module, and it can 
+ *  be bound to the shell at run time with conser_bind().
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* --------------------------------- Module -------------------------------- */
+#ifndef __TRANSPORT_H__
+#define __TRANSPORT_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Allow binding a transport to the console */
+#define TRANSPORT               0
+
+/* ------------------------------- Data types ------------------------------ */
+typedef struct Transport Transport;
+struct Transport
+{
+    /** Take up to len received bytes, it never blocks. Bytes read */
+    unsigned int (*read)(void *ctx, void *buf, unsigned int len);
+
+    /** Send up to len bytes, it never blocks. Bytes taken */
+    unsigned int (*write)(void *ctx, const void *buf, unsigned int len);
+
+    /** True if there is received data to read */
+    int (*poll)(void *ctx);
+
+    /** True if a peer reads the output, NULL if it cannot tell */
+    int (*attached)(void *ctx);
+
+    /** Tell the peer to send or to stop, NULL if the channel cannot */
+    void (*rts)(void *ctx, int ready);
+
+    /** Backend instance */
+    void *ctx;
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Bind a transport to the shell console, NULL goes back to the platform 
+ *  serial channel. Output waits for the transport to take it whole.
+ */
+void conser_bind(const Transport *t);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
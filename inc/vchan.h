@@ -0,0 +1,210 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   vchan.h
+ *  \brief  Virtual channels multiplexed over the shell serial link.
+ *
+ *  Several byte streams share the one serial link: the shell console is 
+ *  channel 0, logs and bulk data get channels of their own. Every channel 
+ *  has its own transmit and receive buffers and credit based flow 
+ *  control, so a bulk stream can neither overrun the peer nor hold back 
+ *  the console, which is always sent first. The same module runs on host 
+ *  side, see tools/vcdemux.c.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Frame, COBS encoded and terminated by a 0x00 byte:
+ *
+ *      <channel << 4 | type> <payload>
+ *
+ *      VCHAN_DATA      up to VCHAN_MTU bytes of the channel stream
+ *      VCHAN_CREDIT    16 bit little endian count of bytes the receiver 
+ *                      has freed on that channel, the sender may send 
+ *                      that many more
+ *      VCHAN_SYNC      no payload, the peer has restarted. Buffers are 
+ *                      emptied and credits reset to VCHAN_BUF
+ *
+ *  Both sides start with VCHAN_BUF bytes of credit on every channel, so 
+ *  both must be built with the same VCHAN_BUF. Frames with unknown 
+ *  channel or type, or longer than the largest one, are dropped and 
+ *  counted.
+ *
+ *  The module is not reentrant. Write, read and poll from the same 
+ *  context, e.g. the main loop.
+ */
+
+/* --------------------------------- Module -------------------------------- */
+#ifndef __VCHAN_H__
+#define __VCHAN_H__
+
+/* ----------------------------- Include files ----------------------------- */
+/* ---------------------- External C language linkage ---------------------- */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------- Macros -------------------------------- */
+/* -------------------------------- Constants ------------------------------ */
+/** Multiplex the shell serial link */
+#define VCHAN                   0
+
+/** Number of channels, up to 16 */
+#define VCHAN_NUM               3
+
+/** Size of every channel buffer. It must be a power of 2 */
+#define VCHAN_BUF               128
+
+/** Largest payload of a data frame, up to 253 */
+#define VCHAN_MTU               32
+
+/** Channels */
+enum
+{
+    VCHAN_SHELL, VCHAN_LOG, VCHAN_BULK
+};
+
+/** Frame types */
+enum
+{
+    VCHAN_DATA, VCHAN_CREDIT, VCHAN_SYNC
+};
+
+/* ------------------------------- Data types ------------------------------ */
+/**
+ *  \brief
+ *  Sends a whole encoded frame, its 0x00 terminator included.
+ */
+typedef void (*VChanTx)(const unsigned char *frame, unsigned int len);
+
+/**
+ *  \brief
+ *  Looks at a received byte once it is out of its frame.
+ *
+ *  \return
+ *  1 if it was taken and must not be queued, otherwise 0.
+ */
+typedef int (*VChanFilter)(unsigned char c);
+
+typedef struct VChanStat VChanStat;
+struct VChanStat
+{
+    unsigned long txframes;
+    unsigned long rxframes;
+    unsigned long bad;          /* dropped malformed frames */
+    unsigned long overruns;     /* received bytes beyond granted credit */
+};
+
+/* -------------------------- External variables --------------------------- */
+/* -------------------------- Function prototypes -------------------------- */
+/**
+ *  \brief
+ *  Empty every buffer, reset credits and set the frame output.
+ */
+void vchan_init(VChanTx tx);
+
+/**
+ *  \brief
+ *  Like vchan_init() but it also tells the peer to do the same. Call it 
+ *  once the link is up.
+ */
+void vchan_sync(void);
+
+/**
+ *  \brief
+ *  Feed one byte received from the serial link.
+ */
+void vchan_rx(unsigned char c);
+
+/**
+ *  \brief
+ *  Send pending credits and data frames. Channel 0 is sent whole, the 
+ *  other channels one frame each per call.
+ */
+void vchan_poll(void);
+
+/**
+ *  \brief
+ *  Queue data to send on a channel, as much as fits.
+ *
+ *  \return
+ *  Number of bytes queued.
+ */
+unsigned int vchan_write(unsigned int ch, const void *data, unsigned int len);
+
+/**
+ *  \brief
+ *  Take received data of a channel. The freed room is granted back to 
+ *  the peer on next vchan_poll().
+ *
+ *  \return
+ *  Number of bytes read.
+ */
+unsigned int vchan_read(unsigned int ch, void *data, unsigned int len);
+
+/**
+ *  \brief
+ *  Number of received bytes ready to be read from a channel.
+ */
+unsigned int vchan_avail(unsigned int ch);
+
+/**
+ *  \brief
+ *  Set the filter of received data of a channel, NULL for none. Bytes it 
+ *  takes are granted back to the peer as if they were read. It is kept 
+ *  across vchan_init() and peer restarts.
+ */
+void vchan_filter(unsigned int ch, VChanFilter fn);
+
+/**
+ *  \brief
+ *  Get the counters.
+ */
+void vchan_stat(VChanStat *st);
+
+/* -------------------- External C language linkage end -------------------- */
+#ifdef __cplusplus
+}
+#endif
+
+/* ------------------------------ Module end ------------------------------- */
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
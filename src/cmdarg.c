@@ -0,0 +1,282 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   cmdarg.c
+ *  \brief  Centralised parsing of typed command arguments.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Four characters are loaded into a 32-bit word, first character in the 
+ *  least significant byte. For decimal digits:
+ *
+ *      x -= "0000"                             d0 d1 d2 d3, one per byte
+ *      x = (x * 10 + (x >> 8)) & 0x00FF00FF    d0d1 and d2d3
+ *      x = (x * 100 + (x >> 16)) & 0xFFFF      d0d1d2d3
+ *
+ *  For hexadecimal digits every byte is first mapped to its nibble with 
+ *  (b & 0xF) + 9 * (b >> 6), then the nibbles are packed by shifts.
+ *  Validation is done on the whole word too, so there is no branch per 
+ *  character.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "cmdarg.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/** 
+ * Set the high bit of every byte of x that is strictly between m and n.
+ * m and n must be lower than 128.
+ */
+#define HAS_BETWEEN(x, m, n) \
+    (((0x01010101UL * (127 + (n)) - ((x) & 0x7F7F7F7FUL)) & ~(x) & \
+      (((x) & 0x7F7F7F7FUL) + 0x01010101UL * (127 - (m)))) & 0x80808080UL)
+
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+#if CMDARG_LITTLE_ENDIAN
+static uint32_t
+load4(const char *s)
+{
+    uint32_t x;
+
+    memcpy(&x, s, sizeof(x));
+    return x;
+}
+#endif
+
+static int
+is_digit(char c)
+{
+    return (unsigned char)(c - '0') < 10;
+}
+
+static int
+hex_digit(char c)
+{
+    if (is_digit(c))
+    {
+        return c - '0';
+    }
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+static int
+conv_dec(const char *s, unsigned long *v)
+{
+    unsigned long acc;
+    size_t len;
+#if CMDARG_LITTLE_ENDIAN
+    uint32_t x;
+#endif
+
+    if ((len = strlen(s)) == 0)
+    {
+        return 1;
+    }
+    acc = 0;
+#if CMDARG_LITTLE_ENDIAN
+    for (; len >= 4; len -= 4, s += 4)
+    {
+        x = load4(s);
+        if ((((x & 0xF0F0F0F0UL) ^ 0x30303030UL) |
+             (((x + 0x06060606UL) & 0xF0F0F0F0UL) ^ 0x30303030UL)) != 0)
+        {
+            return 1;
+        }
+        x -= 0x30303030UL;
+        x = (x * 10 + (x >> 8)) & 0x00FF00FFUL;
+        x = (x * 100 + (x >> 16)) & 0x0000FFFFUL;
+        if (acc > (ULONG_MAX - x) / 10000)
+        {
+            return 1;
+        }
+        acc = acc * 10000 + x;
+    }
+#endif
+    for (; len > 0; --len, ++s)
+    {
+        if (!is_digit(*s) || acc > (ULONG_MAX - 9) / 10)
+        {
+            return 1;
+        }
+        acc = acc * 10 + (*s - '0');
+    }
+    *v = acc;
+    return 0;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+cmdarg_dec(const char *s, long *v)
+{
+    unsigned long u;
+    int neg;
+
+    if ((neg = *s == '-') != 0)
+    {
+        ++s;
+    }
+    if (conv_dec(s, &u) != 0 || 
+        u > (neg ? (unsigned long)LONG_MAX + 1 : (unsigned long)LONG_MAX))
+    {
+        return 1;
+    }
+    *v = neg ? (long)(0 - u) : (long)u;
+    return 0;
+}
+
+int
+cmdarg_hex(const char *s, unsigned long *v)
+{
+    unsigned long acc;
+    size_t len;
+    int d;
+#if CMDARG_LITTLE_ENDIAN
+    uint32_t x;
+#endif
+
+    if (s[0] == '0' && (s[1] | 0x20) == 'x')
+    {
+        s += 2;
+    }
+    if ((len = strlen(s)) == 0 || len > sizeof(unsigned long) * 2)
+    {
+        return 1;
+    }
+    acc = 0;
+#if CMDARG_LITTLE_ENDIAN
+    for (; len >= 4; len -= 4, s += 4)
+    {
+        x = load4(s);
+        if ((HAS_BETWEEN(x, 0x2F, 0x3A) | 
+             HAS_BETWEEN(x | 0x20202020UL, 0x60, 0x67)) != 0x80808080UL)
+        {
+            return 1;
+        }
+        x = (x & 0x0F0F0F0FUL) + 9 * ((x >> 6) & 0x01010101UL);
+        x = ((x << 4) | (x >> 8)) & 0x00FF00FFUL;
+        x = ((x << 8) | (x >> 16)) & 0x0000FFFFUL;
+        acc = (acc << 16) | x;
+    }
+#endif
+    for (; len > 0; --len, ++s)
+    {
+        if ((d = hex_digit(*s)) < 0)
+        {
+            return 1;
+        }
+        acc = (acc << 4) | d;
+    }
+    *v = acc;
+    return 0;
+}
+
+int
+cmdarg_parse(const CMD_EXT *ext, MInt argc, char *argv[], CMD_VAL *vals)
+{
+    const CMD_ARG *arg;
+    const char *const *key;
+    MInt i;
+
+    if (argc - 1 < ext->nreq || argc - 1 > ext->nargs)
+    {
+        return CMDARG_COUNT;
+    }
+
+    vals[0].s = argv[0];
+    for (i = 1, arg = ext->args; i < argc; ++i, ++arg)
+    {
+        switch (arg->type)
+        {
+            case CMD_ARG_INT:
+                if (cmdarg_dec(argv[i], &vals[i].i) != 0)
+                {
+                    return i;
+                }
+                break;
+            case CMD_ARG_HEX:
+                if (cmdarg_hex(argv[i], &vals[i].u) != 0)
+                {
+                    return i;
+                }
+                break;
+            case CMD_ARG_RANGE:
+                if (cmdarg_dec(argv[i], &vals[i].i) != 0 ||
+                    vals[i].i < arg->min || vals[i].i > arg->max)
+                {
+                    return i;
+                }
+                break;
+            case CMD_ARG_ENUM:
+                for (key = arg->keys; *key != NULL; ++key)
+                {
+                    if (strcmp(argv[i], *key) == 0)
+                    {
+                        break;
+                    }
+                }
+                if (*key == NULL)
+                {
+                    return i;
+                }
+                vals[i].i = key - arg->keys;
+                break;
+            default:
+                vals[i].s = argv[i];
+                break;
+        }
+    }
+    return CMDARG_OK;
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,244 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   cmdcache.c
+ *  \brief  Result cache of idempotent read-only commands.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "mytypes.h"
+#include "conser.h"
+#include "contick.h"
+#include "simshell.h"
+#include "cmdcache.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+typedef struct Entry Entry;
+struct Entry
+{
+    const CMD_TABLE *cmdtp;         /* command, only compared */
+    char key[CBSIZE];               /* normalised command line */
+    unsigned long time;             /* tick of the run */
+    unsigned char valid;
+    unsigned int len;
+    char data[CMDCACHE_DATA + 1];
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static Entry cache[CMDCACHE_ENTRIES];
+
+/** Entry being captured, NULL if none */
+static Entry *capt;
+static unsigned char toobig;
+
+static CmdCacheStat stat;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/**
+ *  \brief
+ *  Build the key: full command name and arguments separated by one space, 
+ *  so abbreviations and extra white space hit the same entry. The name is 
+ *  the one of the command within its group, e.g. 'stat' of 'net stat', so 
+ *  entries also keep the command they belong to.
+ *
+ *  \return
+ *  0 if it fits, otherwise the key is truncated and must not be used: 
+ *  the full name may be longer than the abbreviation typed.
+ */
+static int
+make_key(char *key, const CMD_TABLE *cmdtp, MInt argc, char *argv[])
+{
+    const char *s;
+    char *end;
+    MInt i;
+
+    end = key + CBSIZE - 1;
+    for (s = cmdtp->name; *s && key < end; )
+    {
+        *key++ = *s++;
+    }
+    for (i = 1; i < argc && *s == '\0'; ++i)
+    {
+        if (key == end)
+        {
+            break;
+        }
+        *key++ = ' ';
+        for (s = argv[i]; *s && key < end; )
+        {
+            *key++ = *s++;
+        }
+    }
+    *key = '\0';
+    return *s != '\0' || i < argc;
+}
+
+/**
+ *  \brief
+ *  Send the output of an entry, by length since it may hold '\0', e.g.
+ *  CBOR results.
+ */
+static void
+replay(const Entry *e)
+{
+    unsigned int i;
+
+    for (i = 0; i < e->len; ++i)
+    {
+        conser_putc(e->data[i]);
+    }
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+cmdcache_begin(const CMD_TABLE *cmdtp, MInt argc, char *argv[])
+{
+    char key[CBSIZE];
+    Entry *e, *victim;
+    unsigned long now;
+
+    if (make_key(key, cmdtp, argc, argv))
+    {
+        return 0;                           /* not cached */
+    }
+    now = contick_now();
+    victim = NULL;
+    for (e = cache; e < &cache[CMDCACHE_ENTRIES]; ++e)
+    {
+        if (e->valid && e->cmdtp == cmdtp && strcmp(e->key, key) == 0)
+        {
+            if (now - e->time < cmdtp->ext->ttl)
+            {
+                ++stat.hits;
+                replay(e);
+                return 1;
+            }
+            victim = e;                     /* expired, run it again */
+            break;
+        }
+    }
+
+    /* Otherwise reuse a free entry or the oldest one */
+    if (victim == NULL)
+    {
+        for (e = victim = cache; e < &cache[CMDCACHE_ENTRIES]; ++e)
+        {
+            if (!e->valid)
+            {
+                victim = e;
+                break;
+            }
+            if (now - e->time > now - victim->time)
+            {
+                victim = e;
+            }
+        }
+    }
+
+    ++stat.misses;
+    victim->cmdtp = cmdtp;
+    strcpy(victim->key, key);
+    victim->valid = 0;
+    victim->len = 0;
+    victim->time = now;
+    capt = victim;
+    toobig = 0;
+    return 0;
+}
+
+void
+cmdcache_end(MInt rc)
+{
+    if (capt == NULL)
+    {
+        return;
+    }
+    if (toobig)
+    {
+        ++stat.toobig;
+    }
+    else if (rc == 0)
+    {
+        capt->data[capt->len] = '\0';
+        capt->valid = 1;
+    }
+    capt = NULL;
+}
+
+void
+cmdcache_tx(const char *s, unsigned int n)
+{
+    if (capt == NULL || toobig)
+    {
+        return;
+    }
+    if (capt->len + n > CMDCACHE_DATA)
+    {
+        toobig = 1;
+        return;
+    }
+    memcpy(&capt->data[capt->len], s, n);
+    capt->len += n;
+}
+
+void
+cmdcache_flush(void)
+{
+    Entry *e;
+
+    for (e = cache; e < &cache[CMDCACHE_ENTRIES]; ++e)
+    {
+        e->valid = 0;
+    }
+}
+
+void
+cmdcache_stat(CmdCacheStat *st)
+{
+    *st = stat;
+}
+
+/* ------------------------------ End of file ------------------------------ */
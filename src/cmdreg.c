@@ -0,0 +1,245 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   cmdreg.c
+ *  \brief  Runtime registry of commands.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Registered entries are kept in an array that is never modified once 
+ *  published. A writer builds a new array, publishes it and waits for a 
+ *  grace period before freeing the old one.
+ *
+ *  Readers are counted in one of two counters, picked by the parity of 
+ *  the epoch they entered. A grace period moves the epoch forward and 
+ *  waits for the counter of the old parity to drop to zero. A reader 
+ *  checks the epoch again once it is counted, so it is either seen by 
+ *  the writer or it enters the new epoch, where it can only load the new 
+ *  array. Writers are serialized by a spin lock.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "cmdreg.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+typedef struct RegSet RegSet;
+struct RegSet
+{
+    unsigned int n;
+    const CMD_TABLE *cmds[];
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static RegSet *volatile cur;
+static volatile unsigned int epoch;
+static volatile unsigned int readers[2];
+static volatile int wlock;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+synchronize(void)
+{
+    unsigned int e;
+
+    e = __sync_fetch_and_add(&epoch, 1);
+    while (readers[e & 1] != 0)
+    {
+        CMDREG_YIELD();
+    }
+}
+
+static RegSet *
+new_set(unsigned int n)
+{
+    RegSet *s;
+
+    if ((s = malloc(sizeof(RegSet) + n * sizeof(s->cmds[0]))) != NULL)
+    {
+        s->n = n;
+    }
+    return s;
+}
+
+/**
+ *  \brief
+ *  Publish a new array, wait for readers of the old one and free it.
+ */
+static void
+replace(RegSet *s)
+{
+    RegSet *old;
+
+    old = cur;
+    __sync_synchronize();
+    cur = s;
+    synchronize();
+    free(old);
+}
+
+static int
+index_of(const RegSet *s, const char *name)
+{
+    unsigned int i;
+
+    for (i = 0; s != NULL && i < s->n; ++i)
+    {
+        if (strcmp(s->cmds[i]->name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+cmdreg_add(const CMD_TABLE *cmd)
+{
+    RegSet *s;
+    unsigned int n;
+
+    while (__sync_lock_test_and_set(&wlock, 1))
+    {
+        CMDREG_YIELD();
+    }
+    n = cur != NULL ? cur->n : 0;
+    if (index_of(cur, cmd->name) >= 0 || (s = new_set(n + 1)) == NULL)
+    {
+        __sync_lock_release(&wlock);
+        return 1;
+    }
+    if (n != 0)
+    {
+        memcpy(s->cmds, cur->cmds, n * sizeof(s->cmds[0]));
+    }
+    s->cmds[n] = cmd;
+    replace(s);
+    __sync_lock_release(&wlock);
+    return 0;
+}
+
+int
+cmdreg_remove(const char *name)
+{
+    RegSet *s;
+    int i;
+
+    while (__sync_lock_test_and_set(&wlock, 1))
+    {
+        CMDREG_YIELD();
+    }
+    if ((i = index_of(cur, name)) < 0 || (s = new_set(cur->n - 1)) == NULL)
+    {
+        __sync_lock_release(&wlock);
+        return 1;
+    }
+    memcpy(s->cmds, cur->cmds, i * sizeof(s->cmds[0]));
+    memcpy(&s->cmds[i], &cur->cmds[i + 1], 
+           (cur->n - i - 1) * sizeof(s->cmds[0]));
+    replace(s);
+    __sync_lock_release(&wlock);
+    return 0;
+}
+
+unsigned int
+cmdreg_read_lock(void)
+{
+    unsigned int e;
+
+    for (;;)
+    {
+        e = epoch;
+        __sync_fetch_and_add(&readers[e & 1], 1);
+        if (epoch == e)
+        {
+            return e;
+        }
+        __sync_fetch_and_sub(&readers[e & 1], 1);
+    }
+}
+
+void
+cmdreg_read_unlock(unsigned int token)
+{
+    __sync_fetch_and_sub(&readers[token & 1], 1);
+}
+
+const CMD_TABLE *
+cmdreg_find(const char *cmd)
+{
+    const RegSet *s;
+    unsigned int i;
+
+    if ((s = cur) == NULL)
+    {
+        return NULL;
+    }
+    for (i = 0; i < s->n; ++i)
+    {
+#if ABBREVIATED
+        if (strncmp(cmd, s->cmds[i]->name, s->cmds[i]->lmin) == 0)
+#else
+        if (strcmp(cmd, s->cmds[i]->name) == 0)
+#endif
+        {
+            return s->cmds[i];
+        }
+    }
+    return NULL;
+}
+
+const CMD_TABLE *
+cmdreg_at(unsigned int i)
+{
+    const RegSet *s;
+
+    s = cur;
+    return s != NULL && i < s->n ? s->cmds[i] : NULL;
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -62,14 +62,211 @@
 #include "command.h"
 #include "conser.h"
 #include "formats.h"
+#include "cmdshell.h"
+#include "tahead.h"
+#include "cmdcache.h"
+#include "deadline.h"
+#include "conlog.h"
+#include "tagreq.h"
+#include "conring.h"
+#include "flowctl.h"
+
+#include <string.h>
+
+#if RAWLINE
+static const char *const line_modes[] =
+{
+    "edit", "raw",
+#if TAGREQ
+    "tag",
+#endif
+    NULL
+};
+
+static const CMD_ARG line_args[] =
+{
+    MK_ARG_ENUM("mode", line_modes)
+};
+
+static MInt
+do_line(const CMD_TABLE *p, MInt argc, const CMD_VAL *vals)
+{
+    if (argc == 1)
+    {
+        myprintf(0, "%s\n", line_modes[simshell_get_linemode()]);
+    }
+    else
+    {
+        simshell_set_linemode((int)vals[1].i);
+    }
+    return 0;
+}
+
+const CMD_EXT line_ext = {line_args, 1, 0, do_line};
+#endif
 
 MInt
 do_shell(const CMD_TABLE *p, MInt argc, char *argv[])
 {
     myprintf(0, "\n\tCommand shell setup: \n\n");
     myprintf(0, "\t%sdefined longhelp\n", LONGHELP ? "" : "un");
-    myprintf(0, "\tdefined maximum arguments = %01d\n\n", MAXARGS);
+    myprintf(0, "\tdefined maximum arguments = %01d\n", MAXARGS);
+    myprintf(0, "\t%sdefined trace\n", SIMTRACE ? "" : "un");
+#if TAHEAD
+    {
+        TAheadStat st;
+
+        tahead_stat(&st);
+        myprintf(0, "\ttype-ahead lines = %lu, overflows = %lu, "
+                 "too long = %lu\n", st.lines, st.overflows, st.toolong);
+    }
+#endif
+#if CMDCACHE
+    {
+        CmdCacheStat st;
+
+        cmdcache_stat(&st);
+        myprintf(0, "\tresult cache hits = %lu, misses = %lu, "
+                 "too big = %lu\n", st.hits, st.misses, st.toobig);
+    }
+#endif
+#if DEADLINE
+    {
+        DeadlineStat st;
+
+        deadline_stat(&st);
+        myprintf(0, "\tdeadline overruns = %lu, worst = %lu ticks, "
+                 "aborts = %lu\n", st.overruns, st.worst, st.aborts);
+    }
+#endif
+#if CONLOG
+    {
+        ConLogStat st;
+
+        conlog_stat(&st);
+        myprintf(0, "\tlog records = %lu, dropped = %lu\n", st.records,
+                 st.dropped);
+    }
+#endif
+#if CONRING
+    {
+        ConRingStat st;
+
+        conring_stat(&st);
+        myprintf(0, "\tcaptured output = %lu, lost = %lu%s\n", st.captured,
+                 st.lost, conring_detached() ? ", detached" : "");
+    }
+#endif
+#if FLOWCTL
+    {
+        FlowCtlStat st;
+
+        flowctl_stat(&st);
+        myprintf(0, "\tinput pending = %u, peak = %u, xoffs = %lu, "
+                 "late = %lu\n", st.pending, st.peak, st.xoffs, st.late);
+    }
+#endif
+    conser_putc('\n');
+
+    return 0;
+}
+
+#if SIMTRACE
+static SimTraceEvt evts[SIMTRACE_SIZE];
+
+static void
+put_varint(unsigned long v)
+{
+    for (; v >= 0x80; v >>= 7)
+    {
+        conser_putc((char)(v | 0x80));
+    }
+    conser_putc((char)v);
+}
+
+static void
+put_name(const SimTraceEvt *e)
+{
+    unsigned int i;
+
+    for (i = 0; i < SIMTRACE_NAME && e->name[i] != '\0'; ++i)
+    {
+        conser_putc(e->name[i]);
+    }
+}
+
+/*
+ * do_trace:
+ *
+ *      Binary form is "TRC", number of events and then every event as 
+ *      its number, timestamp delta and argument. Numbers are LEB128 
+ *      varints. Command events carry the name, NUL terminated, instead 
+ *      of the argument.
+ */
+
+MInt
+do_trace(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    unsigned int i, n;
+    unsigned long last;
+    const SimTraceEvt *e;
+
+    if (argc == 2 && strcmp(argv[1], "clear") == 0)
+    {
+        simtrace_clear();
+        return 0;
+    }
+
+    n = simtrace_snapshot(evts, SIMTRACE_SIZE);
+    if (argc == 2 && strcmp(argv[1], "bin") == 0)
+    {
+        conser_puts("TRC");
+        put_varint(n);
+        for (i = 0, last = n ? evts[0].ts : 0; i < n; ++i)
+        {
+            conser_putc((char)evts[i].ev);
+            put_varint(evts[i].ts - last);
+            if (evts[i].ev == TRC_HIT || evts[i].ev == TRC_ENTER)
+            {
+                put_name(&evts[i]);
+                conser_putc('\0');
+            }
+            else
+            {
+                put_varint((unsigned long)evts[i].arg);
+            }
+            last = evts[i].ts;
+        }
+        return 0;
+    }
+    if (argc != 1)
+    {
+        return 1;
+    }
 
+    for (i = 0, e = evts; i < n; ++i, ++e)
+    {
+        myprintf(0, "%10lu %-6s ", e->ts, simtrace_name(e->ev));
+        switch (e->ev)
+        {
+            case TRC_HIT:
+            case TRC_ENTER:
+                put_name(e);
+                break;
+            case TRC_RX:
+                myprintf(0, "%02x", (unsigned int)e->arg & 0xFF);
+                break;
+            case TRC_LINE:
+            case TRC_PARSE:
+            case TRC_EXIT:
+                myprintf(0, "%d", (int)e->arg);
+                break;
+            default:
+                break;
+        }
+        conser_putc('\n');
+    }
     return 0;
 }
+#endif
 /* ------------------------------ End of file ------------------------------ */
@@ -72,6 +72,14 @@
 
 #include "cmdshell.h"
 #include "cmdset.h"
+#include "deadline.h"
+#include "script.h"
+#include "cmdreg.h"
+#include "stackhw.h"
+#include "memdump.h"
+#include "prof.h"
+#include "conring.h"
+#include "result.h"
 
 #include <string.h>
 
@@ -130,7 +138,15 @@ static const CMD_TABLE cmd_tbl[] =
 #if HELP
     CMD_TBL_HELP
 #endif
+    CMD_TBL_LINE
+    CMD_TBL_RESULT
     CMD_TBL_SHELL
+    CMD_TBL_TRACE
+    CMD_TBL_SCRIPT
+    CMD_TBL_STACKSTAT
+    CMD_TBL_DUMP
+    CMD_TBL_PROF
+    CMD_TBL_REPLAY
     CMD_TBL_SETB
     CMD_TBL_CLRB
     CMD_TBL_GETB
@@ -179,6 +195,33 @@ do_echo(const CMD_TABLE *cmdtp, MInt argc, char *argv[])
 }
 #endif
 
+#if HELP
+/*
+ * help_at:
+ *
+ *      Command listed at a position by 'help', registered ones after 
+ *      the built-in ones, or NULL past the last one. Registered ones 
+ *      are read within the read section of dispatch.
+ */
+
+static unsigned int next_help;
+
+static
+const CMD_TABLE *
+help_at(unsigned int i)
+{
+    if (i < sizeof(cmd_tbl) / sizeof(cmd_tbl[0]) - 1)
+    {
+        return &cmd_tbl[i];
+    }
+#if CMDREG
+    return cmdreg_at(i - (sizeof(cmd_tbl) / sizeof(cmd_tbl[0]) - 1));
+#else
+    return NULL;
+#endif
+}
+#endif
+
 /*
  * do_help:
  *
@@ -191,6 +234,7 @@ static
 MInt
 do_help(const CMD_TABLE *cmdtp, MInt argc, char *argv[])
 {
+    const CMD_TABLE *p;
     MUInt i;
     MUInt rcode = 0;
 
@@ -198,13 +242,21 @@ do_help(const CMD_TABLE *cmdtp, MInt argc, char *argv[])
 
     if (argc == 1)
     {
-        for (cmdtp = &cmd_tbl[0]; cmdtp->name; cmdtp++)
+        if (!cmd_resumed())
         {
-            if (cmdtp->usage == NULL)
+            next_help = 0;
+        }
+        while ((p = help_at(next_help)) != NULL && !cmd_cancelled())
+        {
+            if (p->usage != NULL)
             {
-                continue;
+                conser_puts(p->usage);
+            }
+            ++next_help;
+            if (cmd_yield())
+            {
+                return CMD_MORE;    /* the rest on next turn */
             }
-            conser_puts(cmdtp->usage);
         }
         return 0;
     }
@@ -215,6 +267,18 @@ do_help(const CMD_TABLE *cmdtp, MInt argc, char *argv[])
     {
         if ((cmdtp = find_cmd(argv[i])) != NULL)
         {
+            /* Go down to the command of a group, if named */
+            while (cmd_is_group(cmdtp) && i + 1 < argc &&
+                   (p = find_cmd_in(cmdtp->ext->sub, argv[i + 1])) != NULL)
+            {
+                cmdtp = p;
+                ++i;
+            }
+            if (cmd_is_group(cmdtp))
+            {
+                list_cmds(cmdtp->ext->sub);
+                continue;
+            }
 #ifdef LONGHELP
             /* found - print (long) help info */
             conser_puts(cmdtp->name);
@@ -255,18 +319,31 @@ do_help(const CMD_TABLE *cmdtp, MInt argc, char *argv[])
 #endif
 
 /*
- * find_cmd:
+ * find_tbl_cmd:
  *
- *      Find command table entry for a command.
+ *      Find command table entry for a command, in the built-in table 
+ *      only. Its entries live forever, so the result may be kept.
  */
 
 const
 CMD_TABLE *
-find_cmd(const char *cmd)
+find_tbl_cmd(const char *cmd)
 {
-    const CMD_TABLE *p;
+    return find_cmd_in(cmd_tbl, cmd);
+}
+
+/*
+ * find_cmd_in:
+ *
+ *      Find command table entry for a command in a table, e.g. the 
+ *      one of a group.
+ */
 
-    for (p = &cmd_tbl[0]; p->name != NULL; ++p)
+const
+CMD_TABLE *
+find_cmd_in(const CMD_TABLE *p, const char *cmd)
+{
+    for (; p->name != NULL; ++p)
 #if ABBREVIATED
         if (strncmp(cmd, p->name, p->lmin) == 0)
 #else
@@ -275,4 +352,46 @@ find_cmd(const char *cmd)
         {return p;}
     return NULL;
 }
+
+/*
+ * list_cmds:
+ *
+ *      Print the usage of every command in a table.
+ */
+
+void
+list_cmds(const CMD_TABLE *p)
+{
+    for (; p->name && !cmd_cancelled(); p++)
+    {
+        if (p->usage == NULL)
+        {
+            continue;
+        }
+        conser_puts(p->usage);
+    }
+}
+
+/*
+ * find_cmd:
+ *
+ *      Find command table entry for a command.
+ */
+
+const
+CMD_TABLE *
+find_cmd(const char *cmd)
+{
+#if CMDREG
+    const CMD_TABLE *p;
+
+    if ((p = find_tbl_cmd(cmd)) != NULL)
+    {
+        return p;
+    }
+    return cmdreg_find(cmd);
+#else
+    return find_tbl_cmd(cmd);
+#endif
+}
 /* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,157 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   conlog.c
+ *  \brief  Asynchronous log records shown between keystrokes.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Bounded ring of fixed size slots. Positions grow forever and every 
+ *  slot holds the lap of the position it expects next, that is the 
+ *  position without its slot index, so a zeroed ring is empty:
+ *
+ *      seq == LAP(pos)             free, the producer of pos may claim it
+ *      seq == LAP(pos) + 1         written, ready to be read by consumer
+ *      seq == LAP(pos) + SLOTS     read, free for the next round
+ *
+ *  A producer claims pos by moving head forward with compare-and-swap, 
+ *  then it copies its text and publishes the slot by storing seq. So a 
+ *  slow producer only holds back its own record and the ones behind it, 
+ *  never the faster producers.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include "conlog.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+#define SLOT(i)                 ring[(i) & (CONLOG_SLOTS - 1)]
+#define LAP(i)                  ((i) & ~(CONLOG_SLOTS - 1))
+
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+typedef struct Slot Slot;
+struct Slot
+{
+    volatile unsigned int seq;
+    char text[CONLOG_LEN];
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static Slot ring[CONLOG_SLOTS];
+static volatile unsigned int head;
+static unsigned int tail;
+static unsigned long records;
+static volatile unsigned long dropped;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+int
+conlog_puts(const char *s)
+{
+    unsigned int pos;
+    unsigned long n;
+    Slot *slot;
+    char *d, *end;
+
+    do
+    {
+        pos = head;
+        slot = &SLOT(pos);
+        if (slot->seq != LAP(pos))
+        {
+            do
+            {
+                n = dropped;
+            }
+            while (!CONLOG_CAS(&dropped, n, n + 1));
+            return 1;
+        }
+    }
+    while (!CONLOG_CAS(&head, pos, pos + 1));
+
+    for (d = slot->text, end = d + CONLOG_LEN - 1; *s && d < end; )
+    {
+        *d++ = *s++;
+    }
+    *d = '\0';
+    CONLOG_BARRIER();
+    slot->seq = LAP(pos) + 1;
+    return 0;
+}
+
+int
+conlog_pending(void)
+{
+    return SLOT(tail).seq == LAP(tail) + 1;
+}
+
+int
+conlog_get(char *rec)
+{
+    Slot *slot;
+    char *s, *d;
+
+    slot = &SLOT(tail);
+    if (slot->seq != LAP(tail) + 1)
+    {
+        return -1;
+    }
+    CONLOG_BARRIER();
+    for (s = slot->text, d = rec; (*d = *s) != '\0'; ++s, ++d)
+    {
+    }
+    CONLOG_BARRIER();
+    slot->seq = LAP(tail) + CONLOG_SLOTS;
+    ++tail;
+    ++records;
+    return d - rec;
+}
+
+void
+conlog_stat(ConLogStat *st)
+{
+    st->records = records;
+    st->dropped = dropped;
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,184 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   conring.c
+ *  \brief  Capture of console output while nobody is attached.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Positions grow forever and are masked on access. Bytes from 
+ *  wr - CONRING_SIZE, but not before the last clear, up to wr are kept.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "mytypes.h"
+#include "conser.h"
+#include "formats.h"
+#include "conring.h"
+
+#if CONRING || defined(__TEST__)
+/* ----------------------------- Local macros ------------------------------ */
+#define AT(i)                   ring[(i) & (CONRING_SIZE - 1)]
+
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static char ring[CONRING_SIZE];
+static unsigned long wr, base;
+static unsigned char detached;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void
+conring_detach(int d)
+{
+    detached = d != 0;
+}
+
+int
+conring_detached(void)
+{
+    return detached;
+}
+
+void
+conring_write(const char *s, unsigned int n)
+{
+    unsigned int i, k;
+
+    if (n > CONRING_SIZE)           /* only the newest bytes fit */
+    {
+        s += n - CONRING_SIZE;
+        wr += n - CONRING_SIZE;
+        n = CONRING_SIZE;
+    }
+    i = wr & (CONRING_SIZE - 1);
+    k = CONRING_SIZE - i < n ? CONRING_SIZE - i : n;
+    memcpy(&ring[i], s, k);
+    memcpy(ring, s + k, n - k);
+    wr += n;
+}
+
+unsigned long
+conring_first(void)
+{
+    return wr - base > CONRING_SIZE ? wr - CONRING_SIZE : base;
+}
+
+unsigned int
+conring_read(unsigned long *pos, char *buf, unsigned int len)
+{
+    unsigned int n;
+
+    if (*pos - conring_first() > wr - conring_first())
+    {
+        *pos = conring_first();     /* overwritten or cleared */
+    }
+    for (n = 0; n < len && *pos != wr; ++n, ++*pos)
+    {
+        buf[n] = AT(*pos);
+    }
+    return n;
+}
+
+void
+conring_clear(void)
+{
+    base = wr;
+}
+
+void
+conring_stat(ConRingStat *st)
+{
+    st->captured = wr - base;
+    st->lost = conring_first() - base;
+}
+#endif
+
+#if CONRING
+MInt
+do_replay(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    ConRingStat st;
+    unsigned long pos, end;
+    unsigned int n, i;
+    char buf[32];
+
+    if (argc == 2)
+    {
+        if (strcmp(argv[1], "clear") != 0)
+        {
+            return 1;
+        }
+        conring_clear();
+        return 0;
+    }
+    if (detached)
+    {
+        return 1;                   /* it would replay into the ring */
+    }
+
+    conring_stat(&st);
+    if (st.lost != 0)
+    {
+        myprintf(0, "** %lu bytes lost **\n", st.lost);
+    }
+    /* Stop at the newest byte, in case the replay is captured too */
+    for (pos = conring_first(), end = wr; pos != end; )
+    {
+        n = end - pos < sizeof(buf) ? end - pos : sizeof(buf);
+        if ((n = conring_read(&pos, buf, n)) == 0)
+        {
+            break;
+        }
+        for (i = 0; i < n; ++i)     /* by length, output may hold '\0' */
+        {
+            conser_putc(buf[i]);
+        }
+    }
+    return 0;
+}
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -58,24 +58,151 @@
 /* ----------------------- Local function prototypes ----------------------- */
 /* ---------------------------- Local functions ---------------------------- */
 /* ---------------------------- Global functions --------------------------- */
+#include <string.h>
 #include "mytypes.h"
 #include "console.h"
+#include "sesrec.h"
+#include "cmdcache.h"
+#include "script.h"
+#include "vchan.h"
+#include "transport.h"
+#include "conring.h"
+#include "simshell.h"
+#include "flowctl.h"
+#include "conabort.h"
 
 #ifdef DOS_PLATFORM
 #include <stdio.h>
 #include <conio.h>
 #include <process.h>
+#elif defined(SESREP_PLATFORM)
+#include "sesrep.h"
 #else
 #include "gsqueue.h"
 #include "qdata.h"
 #include "serial.h"
 #endif
 
+#if VCHAN && !defined(DOS_PLATFORM) && !defined(SESREP_PLATFORM)
+/*
+ *      Console is channel VCHAN_SHELL of the serial link, frames are 
+ *      moved from and to COM1CH every time the shell polls for input.
+ */
+
+static void
+com1_tx(const unsigned char *frame, unsigned int len)
+{
+    while (len--)
+        put_char(COM1CH, *frame++);
+}
+
+static void
+pump(void)
+{
+    unsigned char c;
+
+    while (get_char(COM1CH, &c) != EMPTY_QUEUE)
+    {
+        FLOWCTL_TAKE();
+        vchan_rx(c);
+    }
+    vchan_poll();
+}
+
+static void
+chan_write(const char *s, unsigned int n)
+{
+    unsigned int k;
+
+    while ((k = vchan_write(VCHAN_SHELL, s, n)) < n)
+    {
+        s += k;
+        n -= k;
+        pump();
+    }
+}
+#endif
+
+#if TRANSPORT
+/*
+ *      Transport bound at run time, NULL for the platform serial channel.
+ */
+
+static const Transport *tp;
+
+/*
+ *      Waits for room while the other end is attached. Once it goes away 
+ *      the rest is captured, if CONRING, or dropped.
+ */
+
+static void
+tp_write(const char *s, unsigned int n)
+{
+    unsigned int k;
+
+    while ((k = tp->write(tp->ctx, s, n)) < n)
+    {
+        s += k;
+        n -= k;
+        if (tp->attached != NULL && !tp->attached(tp->ctx))
+        {
+#if CONRING
+            conring_write(s, n);
+#endif
+            return;
+        }
+    }
+}
+
+void
+conser_bind(const Transport *t)
+{
+    tp = t;
+#if FLOWCTL
+    flowctl_reset();                /* pending bytes were of the other one */
+#endif
+}
+#endif
+
+#if CONRING
+/*
+ *      Output goes to the capture ring while nobody is attached, detached 
+ *      on purpose or as told by the bound transport.
+ */
+
+static int
+captured(const char *s, unsigned int n)
+{
+#if TRANSPORT
+    if (tp != NULL && tp->attached != NULL && !tp->attached(tp->ctx))
+    {
+        conring_write(s, n);
+        return 1;
+    }
+#endif
+    if (conring_detached())
+    {
+        conring_write(s, n);
+        return 1;
+    }
+    return 0;
+}
+#endif
+
 void
 conser_init(void)
 {
 #ifdef DOS_PLATFORM
     system("cls");
+#elif VCHAN && !defined(SESREP_PLATFORM)
+    vchan_init(com1_tx);
+#if CONABORT
+    vchan_filter(VCHAN_SHELL, conabort_rx);     /* not from the rx isr */
+#endif
+    vchan_sync();
+#endif
+#if FLOWCTL
+    flowctl_reset();
 #endif
 }
 
@@ -93,8 +220,19 @@ conser_init(void)
 MUInt
 conser_tstc(void)
 {
+#if TRANSPORT
+    if (tp != NULL)
+    {
+        return !tp->poll(tp->ctx);
+    }
+#endif
 #ifdef DOS_PLATFORM
     return 0;
+#elif defined(SESREP_PLATFORM)
+    return sesrep_tstc();
+#elif VCHAN
+    pump();
+    return vchan_avail(VCHAN_SHELL) == 0;
 #else
     if (is_empty_gsqueue(COM1_QUEUE) == EMPTY_QUEUE)
     {
@@ -110,21 +248,83 @@ conser_tstc(void)
 void
 conser_putc(const char c)
 {
+    SIMSHELL_TX(1);
+#if SCRIPT
+    if (script_capture(&c, 1))
+    {
+        return;
+    }
+#endif
+#if CONRING
+    if (captured(&c, 1))
+    {
+        SESREC_TX(&c, 1);
+        CMDCACHE_TX(&c, 1);
+        return;
+    }
+#endif
+#if TRANSPORT
+    if (tp != NULL)
+    {
+        tp_write(&c, 1);
+        SESREC_TX(&c, 1);
+        CMDCACHE_TX(&c, 1);
+        return;
+    }
+#endif
 #ifdef DOS_PLATFORM
     putc(c, stdout);
+#elif defined(SESREP_PLATFORM)
+    sesrep_putc(c);
+#elif VCHAN
+    chan_write(&c, 1);
 #else
     put_char(COM1CH, c);
 #endif
+    SESREC_TX(&c, 1);
+    CMDCACHE_TX(&c, 1);
 }
 
 void
 conser_puts(const char *s)
 {
+    SIMSHELL_TX(strlen(s));
+#if SCRIPT
+    if (script_capture(s, strlen(s)))
+    {
+        return;
+    }
+#endif
+#if CONRING
+    if (captured(s, strlen(s)))
+    {
+        SESREC_TX(s, strlen(s));
+        CMDCACHE_TX(s, strlen(s));
+        return;
+    }
+#endif
+#if TRANSPORT
+    if (tp != NULL)
+    {
+        tp_write(s, strlen(s));
+        SESREC_TX(s, strlen(s));
+        CMDCACHE_TX(s, strlen(s));
+        return;
+    }
+#endif
 #ifdef DOS_PLATFORM
     while (*s)
         conser_putc(*s++);
+#else
+#ifdef SESREP_PLATFORM
+    sesrep_puts(s);
+#elif VCHAN
+    chan_write(s, strlen(s));
 #else
     put_string(COM1CH, s);
+#endif
+    SESREC_TX(s, strlen(s));
+    CMDCACHE_TX(s, strlen(s));
 #endif
 }
 
@@ -138,19 +338,71 @@ conser_puts(const char *s)
 MUInt
 conser_getc(void)
 {
+#if TRANSPORT
+    if (tp != NULL)
+    {
+        unsigned char c;
+
+        if (tp->read(tp->ctx, &c, 1) == 0)
+        {
+            return 0xFF;
+        }
+        FLOWCTL_TAKE();
+        SESREC_RX(c);
+        return c;
+    }
+#endif
 #ifdef DOS_PLATFORM
     return getch();
+#elif defined(SESREP_PLATFORM)
+    return sesrep_getc();
 #else
     unsigned char c;
 
+#if VCHAN
+    if (vchan_read(VCHAN_SHELL, &c, 1) == 0)
+#else
     if (get_char(COM1CH, &c) == EMPTY_QUEUE)
+#endif
     {
         return 0xFF;
     }
     else
     {
+#if !VCHAN
+        FLOWCTL_TAKE();             /* by pump() otherwise */
+#endif
+        SESREC_RX(c);
         return c;
     }
 #endif
 }
+
+#if FLOWCTL
+/*
+ * conser_flow:
+ *
+ *      Tell the host to send or to stop, by the RTS of the bound 
+ *      transport, or by XON/XOFF and RTS on the serial line.
+ */
+
+void
+conser_flow(int ready)
+{
+#if TRANSPORT
+    if (tp != NULL)
+    {
+        if (tp->rts != NULL)
+        {
+            tp->rts(tp->ctx, ready);
+        }
+        return;
+    }
+#endif
+#if FLOWCTL_XONXOFF
+    FLOWCTL_SEND(ready ? FLOWCTL_XON : FLOWCTL_XOFF);
+#endif
+    FLOWCTL_RTS(ready);
+}
+#endif
 /* ------------------------------ End of file ------------------------------ */
@@ -60,6 +60,7 @@
 /* ---------------------------- Global functions --------------------------- */
 #include "mytypes.h"
 #include "console.h"
+#include "deadline.h"
 
 #define is_cmd_timeout()        (tcmd != 0)
 
@@ -80,4 +81,19 @@ set_cmd_timeout(MUInt tout)
 {
     tcmd = tout < CONFIG_CMD_TOUT_MIN ? CONFIG_CMD_TOUT_MIN : tout;
 }
+
+/*
+ *      Free running tick counter.
+ */
+
+volatile unsigned long ctick;
+
+void
+contick_tick(void)
+{
+    ++ctick;
+#if DEADLINE
+    deadline_tick();
+#endif
+}
 /* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,129 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   deadline.c
+ *  \brief  Execution deadlines of command handlers.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include "mytypes.h"
+#include "contick.h"
+#include "deadline.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+volatile unsigned char deadline_token;
+
+/* ---------------------------- Local variables ---------------------------- */
+/** A handler is running */
+static volatile unsigned char running;
+
+/** Start tick and deadline of running handler */
+static unsigned long start;
+static volatile unsigned int limit;
+
+static DeadlineStat stat;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void
+deadline_start(unsigned int ticks)
+{
+    deadline_token = CANCEL_NONE;
+    start = contick_now();
+    limit = ticks;
+    running = 1;
+}
+
+unsigned long
+deadline_stop(void)
+{
+    unsigned long elapsed;
+
+    running = 0;
+    elapsed = contick_now() - start;
+    if (limit == 0 || elapsed <= limit)
+    {
+        return 0;
+    }
+    elapsed -= limit;
+    if (elapsed > stat.worst)
+    {
+        stat.worst = elapsed;
+    }
+    return elapsed;
+}
+
+void
+deadline_tick(void)
+{
+    /* Same test as deadline_stop(), the handler has limit ticks */
+    if (running && limit != 0 && deadline_token == CANCEL_NONE &&
+        contick_now() - start > limit)
+    {
+        deadline_token = CANCEL_DEADLINE;
+        ++stat.overruns;
+    }
+}
+
+void
+deadline_cancel(unsigned char reason)
+{
+    if (running && deadline_token == CANCEL_NONE)
+    {
+        deadline_token = reason;
+        if (reason == CANCEL_CTRLC)
+        {
+            ++stat.aborts;
+        }
+    }
+}
+
+void
+deadline_stat(DeadlineStat *st)
+{
+    *st = stat;
+}
+
+/* ------------------------------ End of file ------------------------------ */
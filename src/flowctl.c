@@ -0,0 +1,129 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+
+/**
+ *  \file   flowctl.c
+ *  \brief  Flow control of console input.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The count goes up in the isr and down in the shell, by atomic 
+ *  operations. Only the isr stops the host and only the shell resumes 
+ *  it, each one when it wins the change of 'stopped'.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include "flowctl.h"
+
+#if FLOWCTL || defined(__TEST__)
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static volatile unsigned int pending, peak, stopped;
+static volatile unsigned long xoffs, late;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void
+flowctl_rx(void)
+{
+    unsigned int n;
+
+    n = __sync_add_and_fetch(&pending, 1);
+    if (n > peak)
+    {
+        peak = n;
+    }
+    if (stopped)
+    {
+        ++late;
+    }
+    else if (n >= FLOWCTL_HIGH &&
+             __sync_bool_compare_and_swap(&stopped, 0, 1))
+    {
+        ++xoffs;
+        conser_flow(0);
+    }
+}
+
+void
+flowctl_take(void)
+{
+    unsigned int n;
+
+    do
+    {
+        if ((n = pending) == 0)
+        {
+            return;                 /* not counted, e.g. no flowctl_rx() */
+        }
+    }
+    while (!__sync_bool_compare_and_swap(&pending, n, n - 1));
+
+    if (n - 1 <= FLOWCTL_LOW && stopped &&
+        __sync_bool_compare_and_swap(&stopped, 1, 0))
+    {
+        conser_flow(1);
+    }
+}
+
+void
+flowctl_reset(void)
+{
+    pending = 0;
+    stopped = 0;
+    conser_flow(1);
+}
+
+void
+flowctl_stat(FlowCtlStat *st)
+{
+    st->xoffs = xoffs;
+    st->late = late;
+    st->pending = pending;
+    st->peak = peak;
+}
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
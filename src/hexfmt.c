@@ -0,0 +1,140 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   hexfmt.c
+ *  \brief  Table-driven hex formatting of memory rows.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include <stdint.h>
+#include "hexfmt.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+#define PAIRS(h) \
+    h "0" h "1" h "2" h "3" h "4" h "5" h "6" h "7" \
+    h "8" h "9" h "a" h "b" h "c" h "d" h "e" h "f"
+
+#define put_byte(s, b)  memcpy((s), &pairs[2 * (b)], 2)
+
+/* ------------------------------- Constants ------------------------------- */
+/** Two digits of every byte */
+static const char pairs[] =
+    PAIRS("0") PAIRS("1") PAIRS("2") PAIRS("3")
+    PAIRS("4") PAIRS("5") PAIRS("6") PAIRS("7")
+    PAIRS("8") PAIRS("9") PAIRS("a") PAIRS("b")
+    PAIRS("c") PAIRS("d") PAIRS("e") PAIRS("f");
+
+/** Text of every byte, '.' if not printable */
+static const char text[] =
+    "................................"
+    " !\"#$%&'()*+,-./0123456789:;<=>?"
+    "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_"
+    "`abcdefghijklmnopqrstuvwxyz{|}~."
+    "................................"
+    "................................"
+    "................................"
+    "................................";
+
+/** Byte order of target, first byte is 1 if little endian */
+static const union
+{
+    uint16_t w;
+    unsigned char b[2];
+} order = {1};
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+unsigned int
+hexfmt_row(char *out, unsigned long addr, const unsigned char *data, 
+           unsigned int len, unsigned int width)
+{
+    char *s;
+    unsigned int i, j, pad;
+
+    for (s = out + HEXFMT_ADDR, i = 0; i < HEXFMT_ADDR / 2; ++i)
+    {
+        s -= 2;
+        put_byte(s, addr & 0xFF);
+        addr >>= 8;
+    }
+    s = out + HEXFMT_ADDR;
+    *s++ = ':';
+
+    if (width == 1)
+    {
+        for (i = 0; i < len; ++i, s += 3)
+        {
+            s[0] = ' ';
+            put_byte(s + 1, data[i]);
+        }
+    }
+    else
+    {
+        for (i = 0; i < len; i += width)
+        {
+            *s++ = ' ';
+            for (j = 0; j < width; ++j, s += 2)
+            {
+                put_byte(s, data[order.b[0] ? i + width - 1 - j : i + j]);
+            }
+        }
+    }
+
+    /* Line up the text of a short row */
+    pad = (HEXFMT_ROW - len) * 2 + (HEXFMT_ROW - len) / width + 2;
+    memset(s, ' ', pad);
+    s += pad;
+
+    for (i = 0; i < len; ++i)
+    {
+        *s++ = text[data[i]];
+    }
+    *s++ = '\n';
+    *s = '\0';
+    return (unsigned int)(s - out);
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -12,6 +12,17 @@
 /* --------------------------------- Notes --------------------------------- */
 /* ----------------------------- Include files ----------------------------- */
 #include "command.h"
+#include "shmring.h"
+#ifdef SESREP_PLATFORM
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simshell.h"
+#include "sesrep.h"
+#elif SHMRING && TRANSPORT
+#include <stdio.h>
+#include "simshell.h"
+#endif
 
 /* ----------------------------- Local macros ------------------------------ */
 /* ------------------------------- Constants ------------------------------- */
@@ -20,10 +31,103 @@
 /* ---------------------------- Local variables ---------------------------- */
 /* ----------------------- Local function prototypes ----------------------- */
 /* ---------------------------- Local functions ---------------------------- */
+#ifdef SESREP_PLATFORM
+/**
+ *  \brief
+ *  Replay a session log against this build.
+ *
+ *  Usage: simshell <log> [-t]
+ *      -t  keep the original timing, otherwise replay at full speed
+ */
+static int
+replay(int argc, char *argv[])
+{
+    FILE *f;
+    unsigned char *log;
+    long len;
+    SesRepStat st;
+    int r;
+
+    if (argc < 2 || (f = fopen(argv[1], "rb")) == NULL)
+    {
+        fprintf(stderr, "usage: %s <log> [-t]\n", argv[0]);
+        return 2;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    rewind(f);
+    if ((log = malloc(len)) == NULL || fread(log, 1, len, f) != (size_t)len)
+    {
+        fclose(f);
+        fprintf(stderr, "%s: cannot read log\n", argv[1]);
+        return 2;
+    }
+    fclose(f);
+
+    /* The initial prompt is not part of the replay */
+    simshell_init();
+    if (sesrep_open(log, len, (argc > 2 && strcmp(argv[2], "-t") == 0) ?
+                    SESREP_TIMED : SESREP_FAST) != SESREP_OK)
+    {
+        fprintf(stderr, "%s: bad session log\n", argv[1]);
+        return 2;
+    }
+    while (!sesrep_done())
+    {
+        simshell_process(0);
+    }
+
+    r = sesrep_result(&st);
+    fprintf(stderr, "rx %lu tx %lu/%lu bytes in %lu us, %.1f bytes/s\n",
+            st.rx, st.tx, st.expected, st.usec,
+            st.usec ? (st.rx + st.tx) * 1e6 / st.usec : 0.0);
+    if (r)
+    {
+        fprintf(stderr, "%lu mismatches, first at TX offset %lu\n",
+                st.mismatches, st.first);
+    }
+    free(log);
+    return r;
+}
+#endif
+
+#if !defined(SESREP_PLATFORM) && SHMRING && TRANSPORT
+/**
+ *  \brief
+ *  Serve the shell over shared memory rings, tools attach by name.
+ *
+ *  Usage: simshell [name]
+ */
+static int
+serve(int argc, char *argv[])
+{
+    ShmLink *link;
+    const char *name;
+
+    name = argc > 1 ? argv[1] : "/simshell";
+    if ((link = shmring_open(name, SHMRING_SHELL)) == NULL)
+    {
+        perror(name);
+        return 2;
+    }
+    conser_bind(shmring_transport(link));
+    simshell_init();
+    for (;;)
+    {
+        simshell_process(0);
+    }
+}
+#endif
+
 /* ---------------------------- Global functions --------------------------- */
 int
 main(int argc, char *argv[])
 {
+#ifdef SESREP_PLATFORM
+    return replay(argc, argv);
+#elif SHMRING && TRANSPORT
+    return serve(argc, argv);
+#endif
 }
 
 /* ------------------------------ End of file ------------------------------ */
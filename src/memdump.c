@@ -0,0 +1,126 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   memdump.c
+ *  \brief  Memory dump command.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "mytypes.h"
+#include "conser.h"
+#include "memdump.h"
+#include "hexfmt.h"
+#include "deadline.h"
+
+#if MEMDUMP
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static const char *const widths[] = {"1", "2", "4", NULL};
+
+static const CMD_ARG dump_args[] =
+{
+    MK_ARG_HEX("addr"),
+    MK_ARG_RANGE("len", 1, LONG_MAX),
+    MK_ARG_ENUM("width", widths)
+};
+
+/* ----------------------- Local function prototypes ----------------------- */
+static MInt do_dump(const CMD_TABLE *p, MInt argc, const CMD_VAL *vals);
+
+/* ---------------------------- Local functions ---------------------------- */
+/**
+ *  \brief
+ *  Read memory in word loads, bytes before and after the aligned part.
+ */
+static void
+fetch(unsigned char *buf, uintptr_t addr, unsigned int len)
+{
+    uint32_t w;
+
+    for (; len != 0 && (addr & 3) != 0; --len, ++addr)
+    {
+        *buf++ = *(const volatile unsigned char *)addr;
+    }
+    for (; len >= 4; len -= 4, addr += 4, buf += 4)
+    {
+        w = *(const volatile uint32_t *)addr;
+        memcpy(buf, &w, 4);
+    }
+    for (; len != 0; --len, ++addr)
+    {
+        *buf++ = *(const volatile unsigned char *)addr;
+    }
+}
+
+static MInt
+do_dump(const CMD_TABLE *p, MInt argc, const CMD_VAL *vals)
+{
+    uintptr_t addr;
+    unsigned long len;
+    unsigned int width, n;
+    unsigned char data[HEXFMT_ROW];
+    char row[HEXFMT_ROWLEN];
+
+    width = argc > 3 ? 1U << vals[3].i : 1;
+    addr = (uintptr_t)vals[1].u & ~(uintptr_t)(width - 1);
+    len = ((unsigned long)vals[2].i + width - 1) & ~(unsigned long)(width - 1);
+
+    for (; len != 0 && !cmd_cancelled(); len -= n, addr += n)
+    {
+        n = len < HEXFMT_ROW ? (unsigned int)len : HEXFMT_ROW;
+        fetch(data, addr, n);
+        hexfmt_row(row, (unsigned long)addr, data, n, width);
+        conser_puts(row);
+    }
+    return 0;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+const CMD_EXT dump_ext = {dump_args, 3, 2, do_dump};
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
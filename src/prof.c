@@ -0,0 +1,363 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   prof.c
+ *  \brief  Sampling profiler.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#if defined(__linux__) && !defined(__TEST__)
+#define _GNU_SOURCE
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/time.h>
+#include <dlfcn.h>
+#define PROF_SIGPROF            1
+#else
+#define PROF_SIGPROF            0
+#endif
+#include <string.h>
+#include "mytypes.h"
+#include "formats.h"
+#include "contick.h"
+#include "prof.h"
+
+#if PROF || defined(__TEST__)
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+#if PROF
+static const char *const prof_ops[] = {"start", "stop", "report", NULL};
+
+enum
+{
+    PROF_START, PROF_STOP, PROF_REPORT
+};
+
+static const CMD_ARG prof_args[] =
+{
+    MK_ARG_ENUM("op", prof_ops),
+    MK_ARG_HEX("lo"),
+    MK_ARG_HEX("hi")
+};
+#endif
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static volatile unsigned long hist[PROF_BUCKETS];
+static volatile unsigned long samples, outside;
+static volatile unsigned char running;
+static unsigned long lo, hi;
+static unsigned int shift;
+
+static const ProfSym *syms;
+static unsigned int nsyms;
+
+/* ----------------------- Local function prototypes ----------------------- */
+#if PROF
+static MInt do_prof(const CMD_TABLE *p, MInt argc, const CMD_VAL *vals);
+#endif
+
+/* ---------------------------- Local functions ---------------------------- */
+#if PROF_SIGPROF
+extern char __executable_start, etext;
+
+static void
+on_sigprof(int sig, siginfo_t *si, void *uc)
+{
+    mcontext_t *mc = &((ucontext_t *)uc)->uc_mcontext;
+
+#if defined(__x86_64__)
+    prof_sample((unsigned long)mc->gregs[REG_RIP]);
+#elif defined(__i386__)
+    prof_sample((unsigned long)mc->gregs[REG_EIP]);
+#elif defined(__aarch64__)
+    prof_sample((unsigned long)mc->pc);
+#elif defined(__arm__)
+    prof_sample((unsigned long)mc->arm_pc);
+#else
+    prof_sample(0);                 /* counted as outside */
+#endif
+}
+
+static void
+arm_timer(unsigned long us)
+{
+    struct itimerval it;
+    struct sigaction sa;
+
+    if (us != 0)
+    {
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = on_sigprof;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGPROF, &sa, NULL);
+    }
+    it.it_interval.tv_sec = it.it_value.tv_sec = 0;
+    it.it_interval.tv_usec = it.it_value.tv_usec = us;
+    setitimer(ITIMER_PROF, &it, NULL);
+}
+#endif
+
+/**
+ *  \brief
+ *  Symbol holding an address, NULL if none.
+ */
+static const ProfSym *
+find_sym(unsigned long addr)
+{
+    unsigned int l, h, m;
+
+    for (l = 0, h = nsyms; l < h; )     /* first one above addr */
+    {
+        m = (l + h) / 2;
+        if (syms[m].addr <= addr)
+        {
+            l = m + 1;
+        }
+        else
+        {
+            h = m;
+        }
+    }
+    return l == 0 ? NULL : &syms[l - 1];
+}
+
+/**
+ *  \brief
+ *  Put a hot spot in its place, most samples first, if there is room.
+ */
+static void
+rank(ProfHot *hot, unsigned int *nhot, unsigned int n, const ProfHot *h)
+{
+    unsigned int i;
+
+    if (h->count == 0)
+    {
+        return;
+    }
+    for (i = *nhot; i > 0 && hot[i - 1].count < h->count; --i)
+    {
+        if (i < n)
+        {
+            hot[i] = hot[i - 1];
+        }
+    }
+    if (i < n)
+    {
+        hot[i] = *h;
+        if (*nhot < n)
+        {
+            ++*nhot;
+        }
+    }
+}
+
+#if PROF
+static MInt
+do_prof(const CMD_TABLE *p, MInt argc, const CMD_VAL *vals)
+{
+    ProfHot hot[PROF_TOP];
+    unsigned int i, n;
+#if PROF_SIGPROF
+    Dl_info di;
+#endif
+
+    switch (vals[1].i)
+    {
+        case PROF_START:
+            if (argc == 3 ||
+                prof_start(argc > 3 ? vals[2].u : 0, argc > 3 ? vals[3].u : 0))
+            {
+                myprintf(0, "Bad range\n");
+                return 1;
+            }
+            return 0;
+        case PROF_STOP:
+            prof_stop();
+            return 0;
+        default:
+            break;
+    }
+
+    myprintf(0, "%lu samples, %lu out of 0x%lx-0x%lx, %u bytes a range\n",
+             samples, outside, lo, hi, 1U << shift);
+    for (i = 0, n = prof_top(hot, PROF_TOP); i < n; ++i)
+    {
+#if PROF_SIGPROF
+        if (hot[i].name == NULL && dladdr((void *)hot[i].addr, &di) &&
+            di.dli_sname != NULL)
+        {
+            hot[i].name = di.dli_sname;
+        }
+#endif
+        myprintf(0, "%3u%% %10lu  0x%lx %s\n",
+                 (unsigned int)(hot[i].count * 100 / samples),
+                 hot[i].count, hot[i].addr,
+                 hot[i].name != NULL ? hot[i].name : "");
+    }
+    return 0;
+}
+
+#endif
+
+/* ---------------------------- Global functions --------------------------- */
+#if PROF
+const CMD_EXT prof_ext = {prof_args, 3, 1, do_prof};
+#endif
+
+int
+prof_start(unsigned long l, unsigned long h)
+{
+    prof_stop();
+    if (l == 0 && h == 0)
+    {
+#if PROF_SIGPROF && PROF_TEXT_END == 0
+        l = (unsigned long)&__executable_start;
+        h = (unsigned long)&etext;
+#else
+        l = PROF_TEXT_START;
+        h = PROF_TEXT_END;
+#endif
+    }
+    if (h <= l)
+    {
+        return 1;
+    }
+
+    for (shift = 0; ((h - l - 1) >> shift) >= PROF_BUCKETS; ++shift)
+        ;
+    lo = l;
+    hi = h;
+    memset((void *)hist, 0, sizeof(hist));
+    samples = outside = 0;
+    running = 1;
+#if PROF_SIGPROF
+    arm_timer(CONTICK_PERIOD_US);
+#endif
+    return 0;
+}
+
+void
+prof_stop(void)
+{
+#if PROF_SIGPROF
+    if (running)
+    {
+        arm_timer(0);
+    }
+#endif
+    running = 0;
+}
+
+void
+prof_sample(unsigned long pc)
+{
+    if (!running)
+    {
+        return;
+    }
+    ++samples;
+    if (pc - lo < hi - lo)
+    {
+        ++hist[(pc - lo) >> shift];
+    }
+    else
+    {
+        ++outside;
+    }
+}
+
+void
+prof_symbols(const ProfSym *s, unsigned int n)
+{
+    syms = s;
+    nsyms = s != NULL ? n : 0;
+}
+
+unsigned int
+prof_top(ProfHot *hot, unsigned int n)
+{
+    unsigned int i, nhot;
+    unsigned long addr;
+    const ProfSym *s, *cur;
+    ProfHot h;
+
+    cur = NULL;
+    h.count = 0;
+    h.addr = 0;
+    h.name = NULL;
+    for (i = 0, nhot = 0; i < PROF_BUCKETS; ++i)
+    {
+        addr = lo + ((unsigned long)i << shift);
+        if (addr >= hi)
+        {
+            break;
+        }
+        s = find_sym(addr);
+        if (s == NULL || s != cur)
+        {
+            /* Next range or function */
+            cur = s;
+            rank(hot, &nhot, n, &h);
+            h.count = 0;
+            h.addr = s != NULL ? s->addr : addr;
+            h.name = s != NULL ? s->name : NULL;
+        }
+        h.count += hist[i];
+    }
+    rank(hot, &nhot, n, &h);
+    return nhot;
+}
+
+void
+prof_stat(ProfStat *st)
+{
+    st->samples = samples;
+    st->outside = outside;
+    st->lo = lo;
+    st->hi = hi;
+    st->running = running;
+}
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,435 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+
+/**
+ *  \file   result.c
+ *  \brief  Structured results of commands, as text or CBOR.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Open containers are tracked in both modes, so that the mode may 
+ *  change between commands at any time. Text needs them to know when a 
+ *  map takes a key and how deep to indent.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include "mytypes.h"
+#include "conser.h"
+#include "result.h"
+#include "cmdcache.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* CBOR major types */
+enum
+{
+    MT_UINT, MT_NEG, MT_BYTES, MT_TEXT, MT_ARRAY, MT_MAP, MT_TAG, MT_SIMPLE
+};
+
+#define CBOR_FALSE              0xF4
+#define CBOR_TRUE               0xF5
+#define CBOR_INDEF              31
+#define CBOR_BREAK              0xFF
+
+/* ---------------------------- Local data types --------------------------- */
+typedef struct Level Level;
+struct Level
+{
+    unsigned int left;          /* items to go, or RESULT_INDEF */
+    unsigned char map;
+    unsigned char key;          /* a map waits for a key */
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static int mode;
+static Level stack[RESULT_DEPTH];
+static unsigned int depth;
+
+static const char hex[] = "0123456789abcdef";
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+cbor_head(unsigned int major, unsigned long v)
+{
+    unsigned int n, add;
+
+    if (v < 24)
+    {
+        conser_putc((char)(major << 5 | v));
+        return;
+    }
+    if (v <= 0xFFUL)
+    {
+        n = 1, add = 24;
+    }
+    else if (v <= 0xFFFFUL)
+    {
+        n = 2, add = 25;
+    }
+    else if (((v >> 16) >> 16) == 0)
+    {
+        n = 4, add = 26;
+    }
+    else
+    {
+        n = 8, add = 27;
+    }
+    conser_putc((char)(major << 5 | add));
+    while (n-- > 0)
+    {
+        conser_putc(n < sizeof(v) ? (char)(v >> (n * 8)) : 0);
+    }
+}
+
+static void
+put_ulong(unsigned long v)
+{
+    char buf[3 * sizeof(v) + 1], *p;
+
+    p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    do
+    {
+        *--p = (char)('0' + v % 10);
+    }
+    while ((v /= 10) != 0);
+    conser_puts(p);
+}
+
+static void
+indent(void)
+{
+    unsigned int i;
+
+    for (i = 1; i < depth; ++i)
+    {
+        conser_puts("  ");
+    }
+}
+
+static int
+is_key(void)
+{
+    return depth != 0 && stack[depth - 1].key;
+}
+
+/* Text before an item, a container if 'open' */
+static void
+text_head(int open)
+{
+    if (depth == 0)
+    {
+        return;
+    }
+    if (!stack[depth - 1].map)
+    {
+        indent();
+        if (open)
+        {
+            conser_puts("-\n");
+        }
+    }
+    else if (stack[depth - 1].key)
+    {
+        indent();
+    }
+    else
+    {
+        conser_putc(open ? '\n' : ' ');
+    }
+}
+
+/* Text after a scalar */
+static void
+text_tail(int key)
+{
+    conser_putc(key ? ':' : '\n');
+}
+
+/* An item is complete, so are the containers it fills up */
+static void
+done(void)
+{
+    Level *top;
+
+    while (depth > 0)
+    {
+        top = &stack[depth - 1];
+        if (top->key)
+        {
+            top->key = 0;
+            return;
+        }
+        top->key = top->map;
+        if (top->left == RESULT_INDEF || --top->left != 0)
+        {
+            return;
+        }
+        --depth;
+    }
+}
+
+static void
+begin(unsigned int major, unsigned int n)
+{
+    if (mode == RESULT_CBOR)
+    {
+        if (n == RESULT_INDEF)
+        {
+            conser_putc((char)(major << 5 | CBOR_INDEF));
+        }
+        else
+        {
+            cbor_head(major, n);
+        }
+    }
+    else
+    {
+        text_head(1);
+    }
+
+    if (n == 0)
+    {
+        done();
+    }
+    else if (depth < RESULT_DEPTH)
+    {
+        stack[depth].left = n;
+        stack[depth].map = stack[depth].key = major == MT_MAP;
+        ++depth;
+    }
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+result_set_mode(int m)
+{
+    mode = m;
+}
+
+int
+result_get_mode(void)
+{
+    return mode;
+}
+
+void
+result_reset(void)
+{
+    depth = 0;
+}
+
+void
+result_map(unsigned int pairs)
+{
+    begin(MT_MAP, pairs);
+}
+
+void
+result_array(unsigned int items)
+{
+    begin(MT_ARRAY, items);
+}
+
+void
+result_end(void)
+{
+    if (mode == RESULT_CBOR)
+    {
+        conser_putc((char)CBOR_BREAK);
+    }
+    if (depth != 0 && stack[depth - 1].left == RESULT_INDEF)
+    {
+        --depth;
+        done();
+    }
+}
+
+void
+result_uint(unsigned long v)
+{
+    int key = is_key();
+
+    if (mode == RESULT_CBOR)
+    {
+        cbor_head(MT_UINT, v);
+    }
+    else
+    {
+        text_head(0);
+        put_ulong(v);
+        text_tail(key);
+    }
+    done();
+}
+
+void
+result_int(long v)
+{
+    int key = is_key();
+
+    if (v >= 0)
+    {
+        result_uint((unsigned long)v);
+        return;
+    }
+    if (mode == RESULT_CBOR)
+    {
+        cbor_head(MT_NEG, (unsigned long)-(v + 1));
+    }
+    else
+    {
+        text_head(0);
+        conser_putc('-');
+        put_ulong((unsigned long)-(v + 1) + 1);
+        text_tail(key);
+    }
+    done();
+}
+
+void
+result_bool(int v)
+{
+    int key = is_key();
+
+    if (mode == RESULT_CBOR)
+    {
+        conser_putc((char)(v ? CBOR_TRUE : CBOR_FALSE));
+    }
+    else
+    {
+        text_head(0);
+        conser_puts(v ? "true" : "false");
+        text_tail(key);
+    }
+    done();
+}
+
+void
+result_bytes(const void *data, unsigned int len)
+{
+    const unsigned char *p = data;
+    int key = is_key();
+
+    if (mode == RESULT_CBOR)
+    {
+        cbor_head(MT_BYTES, len);
+        while (len-- > 0)
+        {
+            conser_putc((char)*p++);
+        }
+    }
+    else
+    {
+        text_head(0);
+        for (; len > 0; --len, ++p)
+        {
+            conser_putc(hex[*p >> 4]);
+            conser_putc(hex[*p & 0x0F]);
+            if (len > 1)
+            {
+                conser_putc(' ');
+            }
+        }
+        text_tail(key);
+    }
+    done();
+}
+
+void
+result_str(const char *s)
+{
+    unsigned int len;
+    int key = is_key();
+
+    if (mode == RESULT_CBOR)
+    {
+        for (len = 0; s[len] != '\0'; ++len)
+            ;
+        cbor_head(MT_TEXT, len);
+    }
+    else
+    {
+        text_head(0);
+    }
+    conser_puts(s);
+    if (mode != RESULT_CBOR)
+    {
+        text_tail(key);
+    }
+    done();
+}
+
+#if RESULT
+static const char *const result_modes[] =
+{
+    "text", "cbor", NULL
+};
+
+static const CMD_ARG result_args[] =
+{
+    MK_ARG_ENUM("mode", result_modes)
+};
+
+static MInt
+do_result(const CMD_TABLE *p, MInt argc, const CMD_VAL *vals)
+{
+    if (argc == 1)
+    {
+        conser_puts(result_modes[mode]);
+        conser_putc('\n');
+    }
+    else if (mode != (int)vals[1].i)
+    {
+        mode = (int)vals[1].i;
+#if CMDCACHE
+        cmdcache_flush();           /* it holds results of the other mode */
+#endif
+    }
+    return 0;
+}
+
+const CMD_EXT result_ext = {result_args, 1, 0, do_result};
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,918 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   script.c
+ *  \brief  On-device script engine.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Bytecode, numbers are little endian and jump targets are offsets from 
+ *  the start of script:
+ *
+ *      OP_CMD  <argc> <arg>...     first ones name the command
+ *      OP_LET  <v> <argc> <arg>...
+ *      OP_SET  <v> <expr>
+ *      OP_JZ   <expr> <target16>
+ *      OP_JMP  <target16>
+ *      OP_LOOP <expr> <target16>   push counter, jump to target if <= 0
+ *      OP_NEXT <target16>          jump to target while --counter > 0
+ *      OP_HALT
+ *
+ *      arg     ARG_LIT <string> '\0' | ARG_VAR <v>
+ *      expr    <operand> <op> [<operand>], no second operand if op is 
+ *              OP_NONE
+ *      operand OPD_IMM <long> | OPD_VAR <v>, sizeof(long) bytes
+ *
+ *  Commands are kept by name and looked up when they run, as registered 
+ *  ones may come and go while the script is stored.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "mytypes.h"
+#include "conser.h"
+#include "formats.h"
+#include "command.h"
+#include "cmdarg.h"
+#include "cmdreg.h"
+#include "deadline.h"
+#include "simshell.h"
+#include "script.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+enum
+{
+    OP_CMD, OP_LET, OP_SET, OP_JZ, OP_JMP, OP_LOOP, OP_NEXT, OP_HALT
+};
+
+enum
+{
+    ARG_LIT, ARG_VAR
+};
+
+enum
+{
+    OPD_IMM, OPD_VAR
+};
+
+/** Operators, in the same order as ops[] */
+enum
+{
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_AND, OP_OR,
+    OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE,
+    OP_NONE
+};
+
+/** Kinds of blocks */
+enum
+{
+    BLK_LOOP, BLK_WHILE, BLK_IF, BLK_ELSE
+};
+
+#define NUM_VARS                26
+
+/* ---------------------------- Local data types --------------------------- */
+typedef struct Script Script;
+struct Script
+{
+    char name[SCRIPT_NAME + 1];     /* "" if free */
+    unsigned int off;               /* start of bytecode in arena */
+    unsigned int len;
+};
+
+typedef struct Block Block;
+struct Block
+{
+    unsigned char kind;
+    unsigned int top;               /* first instruction of block */
+    unsigned int patch;             /* jump target to fill at its end */
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static const char *const ops[] =
+{
+    "+", "-", "*", "/", "%", "&", "|", "==", "!=", "<", ">", "<=", ">=", NULL
+};
+
+static unsigned char arena[SCRIPT_ARENA];
+static Script dir[SCRIPT_MAX];
+
+/** Bytes of arena used by stored scripts */
+static unsigned int used;
+
+/** Script being defined, its slot keeps the old one until it compiles */
+static Script *def;
+static char defname[SCRIPT_NAME + 1];
+static unsigned int clen, lineno;
+static unsigned char failed;        /* swallow lines up to '.' */
+static Block blk[SCRIPT_DEPTH];
+static unsigned int nblk;
+static const char *err;
+
+/** Run time state */
+static long var[NUM_VARS];
+static long cnt[SCRIPT_DEPTH];
+static unsigned char capturing;
+static char capt[SCRIPT_CAPTURE];
+static unsigned int ncapt;
+static unsigned char running;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static Script *
+lookup(const char *name)
+{
+    Script *s;
+
+    for (s = dir; s < &dir[SCRIPT_MAX]; ++s)
+    {
+        if (s->name[0] != '\0' && strcmp(s->name, name) == 0)
+        {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static void
+emit(unsigned char b)
+{
+    if (used + clen >= SCRIPT_ARENA)
+    {
+        err = "out of memory";
+        return;
+    }
+    arena[used + clen++] = b;
+}
+
+static void
+emit16(unsigned int v)
+{
+    emit((unsigned char)v);
+    emit((unsigned char)(v >> 8));
+}
+
+static void
+patch16(unsigned int at, unsigned int v)
+{
+    arena[used + at] = (unsigned char)v;
+    arena[used + at + 1] = (unsigned char)(v >> 8);
+}
+
+static int
+var_index(const char *s)
+{
+    return (s[0] >= 'a' && s[0] <= 'z' && s[1] == '\0') ? s[0] - 'a' : -1;
+}
+
+static void
+compile_operand(const char *s)
+{
+    long v;
+    unsigned long u;
+    int i;
+
+    if ((i = var_index(s)) >= 0)
+    {
+        emit(OPD_VAR);
+        emit((unsigned char)i);
+        return;
+    }
+    if (s[0] == '0' && (s[1] | 0x20) == 'x')
+    {
+        if (cmdarg_hex(s, &u) != 0)
+        {
+            err = "bad number";
+            return;
+        }
+        v = (long)u;
+    }
+    else if (cmdarg_dec(s, &v) != 0)
+    {
+        err = "bad operand";
+        return;
+    }
+    emit(OPD_IMM);
+    for (i = 0, u = (unsigned long)v; i < (int)sizeof(long); ++i, u >>= 8)
+    {
+        emit((unsigned char)u);
+    }
+}
+
+static void
+compile_expr(int ntok, char *tok[])
+{
+    const char *const *op;
+
+    if (ntok == 1)
+    {
+        compile_operand(tok[0]);
+        emit(OP_NONE);
+        return;
+    }
+    if (ntok != 3)
+    {
+        err = "bad expression";
+        return;
+    }
+    for (op = ops; *op != NULL && strcmp(*op, tok[1]) != 0; ++op)
+    {
+    }
+    if (*op == NULL)
+    {
+        err = "bad operator";
+        return;
+    }
+    compile_operand(tok[0]);
+    emit((unsigned char)(op - ops));
+    compile_operand(tok[2]);
+}
+
+/**
+ *  \brief
+ *  Check the command is known now, going down groups as the shell does.
+ */
+static void
+check_cmd(int ntok, char *tok[])
+{
+    const CMD_TABLE *cmdtp, *grp;
+#if CMDREG
+    unsigned int rd;
+
+    rd = cmdreg_read_lock();
+#endif
+    if ((cmdtp = find_cmd(tok[0])) == NULL)
+    {
+        err = "unknown command";
+    }
+    else
+    {
+        while (cmd_is_group(cmdtp) && ntok > 1 &&
+               (grp = find_cmd_in(cmdtp->ext->sub, tok[1])) != NULL)
+        {
+            cmdtp = grp;
+            --ntok;
+            ++tok;
+        }
+        if (cmd_is_group(cmdtp))
+        {
+            err = "group without command";
+        }
+        else if (ntok > cmdtp->maxargs)
+        {
+            err = "too many args";
+        }
+    }
+#if CMDREG
+    cmdreg_read_unlock(rd);
+#endif
+}
+
+static void
+compile_cmd(int ntok, char *tok[])
+{
+    const char *s;
+    int i;
+
+    check_cmd(ntok, tok);
+    if (err != NULL)
+    {
+        return;
+    }
+    emit((unsigned char)ntok);
+    for (i = 0; i < ntok; ++i)
+    {
+        if (tok[i][0] == '$' && var_index(tok[i] + 1) >= 0)
+        {
+            emit(ARG_VAR);
+            emit((unsigned char)var_index(tok[i] + 1));
+            continue;
+        }
+        emit(ARG_LIT);
+        for (s = tok[i]; *s; ++s)
+        {
+            emit(*s);
+        }
+        emit('\0');
+    }
+}
+
+static Block *
+open_block(unsigned char kind)
+{
+    Block *b;
+
+    if (nblk == SCRIPT_DEPTH)
+    {
+        err = "too deep";
+        return NULL;
+    }
+    b = &blk[nblk++];
+    b->kind = kind;
+    b->top = clen;
+    return b;
+}
+
+static void
+close_block(void)
+{
+    Block *b;
+
+    if (nblk == 0)
+    {
+        err = "'end' without block";
+        return;
+    }
+    b = &blk[--nblk];
+    switch (b->kind)
+    {
+        case BLK_LOOP:
+            emit(OP_NEXT);
+            emit16(b->top);
+            break;
+        case BLK_WHILE:
+            emit(OP_JMP);
+            emit16(b->top);
+            break;
+        default:
+            break;
+    }
+    if (err == NULL)
+    {
+        patch16(b->patch, clen);
+    }
+}
+
+static int
+split(char *line, char *tok[])
+{
+    int n;
+
+    for (n = 0; n < MAXARGS; )
+    {
+        while (*line == ' ' || *line == '\t')
+        {
+            ++line;
+        }
+        if (*line == '\0')
+        {
+            break;
+        }
+        tok[n++] = line;
+        while (*line && *line != ' ' && *line != '\t')
+        {
+            ++line;
+        }
+        if (*line != '\0')
+        {
+            *line++ = '\0';
+        }
+    }
+    return n;
+}
+
+static void
+compile_line(int ntok, char *tok[])
+{
+    Block *b;
+    int v;
+
+    if (strcmp(tok[0], "set") == 0 || strcmp(tok[0], "let") == 0)
+    {
+        if (ntok < 3 || (v = var_index(tok[1])) < 0)
+        {
+            err = "bad assignment";
+            return;
+        }
+        if (tok[0][0] == 's')
+        {
+            emit(OP_SET);
+            emit((unsigned char)v);
+            compile_expr(ntok - 2, &tok[2]);
+        }
+        else
+        {
+            emit(OP_LET);
+            emit((unsigned char)v);
+            compile_cmd(ntok - 2, &tok[2]);
+        }
+    }
+    else if (strcmp(tok[0], "loop") == 0)
+    {
+        if ((b = open_block(BLK_LOOP)) != NULL)
+        {
+            emit(OP_LOOP);
+            compile_expr(ntok - 1, &tok[1]);
+            b->patch = clen;
+            emit16(0);
+            b->top = clen;
+        }
+    }
+    else if (strcmp(tok[0], "while") == 0 || strcmp(tok[0], "if") == 0)
+    {
+        if ((b = open_block(tok[0][0] == 'w' ? BLK_WHILE : BLK_IF)) != NULL)
+        {
+            emit(OP_JZ);
+            compile_expr(ntok - 1, &tok[1]);
+            b->patch = clen;
+            emit16(0);
+        }
+    }
+    else if (strcmp(tok[0], "else") == 0)
+    {
+        if (nblk == 0 || blk[nblk - 1].kind != BLK_IF)
+        {
+            err = "'else' without 'if'";
+            return;
+        }
+        b = &blk[nblk - 1];
+        emit(OP_JMP);
+        emit16(0);
+        if (err == NULL)
+        {
+            patch16(b->patch, clen);
+        }
+        b->kind = BLK_ELSE;
+        b->patch = clen - 2;
+    }
+    else if (strcmp(tok[0], "end") == 0)
+    {
+        close_block();
+    }
+    else
+    {
+        emit(OP_CMD);
+        compile_cmd(ntok, tok);
+    }
+}
+
+static unsigned int
+get16(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static const unsigned char *
+get_operand(const unsigned char *p, long *v)
+{
+    unsigned long u;
+    int i;
+
+    if (*p++ == OPD_VAR)
+    {
+        *v = var[*p];
+        return p + 1;
+    }
+    for (i = sizeof(long), u = 0; i-- > 0; )
+    {
+        u = (u << 8) | p[i];
+    }
+    *v = (long)u;
+    return p + sizeof(long);
+}
+
+static const unsigned char *
+eval(const unsigned char *p, long *v)
+{
+    long a, b;
+    unsigned char op;
+
+    p = get_operand(p, &a);
+    if ((op = *p++) == OP_NONE)
+    {
+        *v = a;
+        return p;
+    }
+    p = get_operand(p, &b);
+    switch (op)
+    {
+        case OP_ADD: *v = a + b; break;
+        case OP_SUB: *v = a - b; break;
+        case OP_MUL: *v = a * b; break;
+        case OP_DIV: *v = b != 0 ? a / b : 0; break;
+        case OP_MOD: *v = b != 0 ? a % b : 0; break;
+        case OP_AND: *v = a & b; break;
+        case OP_OR:  *v = a | b; break;
+        case OP_EQ:  *v = a == b; break;
+        case OP_NE:  *v = a != b; break;
+        case OP_LT:  *v = a < b; break;
+        case OP_GT:  *v = a > b; break;
+        case OP_LE:  *v = a <= b; break;
+        default:     *v = a >= b; break;
+    }
+    return p;
+}
+
+static char *
+ltoa10(long v, char *end)
+{
+    unsigned long u;
+
+    *--end = '\0';
+    u = v < 0 ? 0 - (unsigned long)v : (unsigned long)v;
+    do
+    {
+        *--end = (char)('0' + u % 10);
+    }
+    while ((u /= 10) != 0);
+    if (v < 0)
+    {
+        *--end = '-';
+    }
+    return end;
+}
+
+/**
+ *  \brief
+ *  Run the command at p, with its arguments already split.
+ */
+static const unsigned char *
+exec_cmd(const unsigned char *p, int *rc)
+{
+    const CMD_TABLE *cmdtp;
+    char *av[MAXARGS + 1];
+    char num[MAXARGS][3 * sizeof(long) + 2];    /* sign, digits, NUL */
+    int argc, i;
+#if CMDREG
+    unsigned int rd;
+#endif
+
+    argc = *p++;
+    for (i = 0; i < argc; ++i)
+    {
+        if (*p++ == ARG_VAR)
+        {
+            av[i] = ltoa10(var[*p++], num[i] + sizeof(num[i]));
+        }
+        else
+        {
+            av[i] = (char *)p;
+            p += strlen((const char *)p) + 1;
+        }
+    }
+    av[argc] = NULL;
+#if CMDREG
+    rd = cmdreg_read_lock();
+#endif
+    if ((cmdtp = find_cmd(av[0])) == NULL)
+    {
+        myprintf(0, "Unknown command '%s'\n", av[0]);
+        *rc = -1;
+    }
+    else
+    {
+        *rc = simshell_exec(cmdtp, argc, av);
+    }
+#if CMDREG
+    cmdreg_read_unlock(rd);
+#endif
+    return p;
+}
+
+/**
+ *  \brief
+ *  Find the first number in captured output, decimal or 0x hexadecimal.
+ */
+static long
+captured_number(void)
+{
+    char *s, *e;
+    long v;
+    unsigned long u;
+
+    capt[ncapt] = '\0';
+    for (s = capt; *s; ++s)
+    {
+        if ((unsigned char)(*s - '0') < 10 ||
+            (*s == '-' && (unsigned char)(s[1] - '0') < 10))
+        {
+            break;
+        }
+    }
+    if (s[0] == '0' && (s[1] | 0x20) == 'x')
+    {
+        for (e = s + 2; (unsigned char)(*e - '0') < 10 ||
+             (unsigned char)((*e | 0x20) - 'a') < 6; ++e)
+        {
+        }
+        *e = '\0';
+        return cmdarg_hex(s, &u) == 0 ? (long)u : 0;
+    }
+    for (e = s + (*s == '-'); (unsigned char)(*e - '0') < 10; ++e)
+    {
+    }
+    *e = '\0';
+    return cmdarg_dec(s, &v) == 0 ? v : 0;
+}
+
+/**
+ *  \brief
+ *  Free a script, moving down the following ones and the extra bytes 
+ *  being compiled past them.
+ */
+static void
+drop(Script *s, unsigned int extra)
+{
+    Script *t;
+
+    memmove(&arena[s->off], &arena[s->off + s->len],
+            used + extra - s->off - s->len);
+    for (t = dir; t < &dir[SCRIPT_MAX]; ++t)
+    {
+        if (t->name[0] != '\0' && t->off > s->off)
+        {
+            t->off -= s->len;
+        }
+    }
+    used -= s->len;
+    s->name[0] = '\0';
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+script_define(const char *name)
+{
+    Script *s;
+
+    if (strlen(name) > SCRIPT_NAME)
+    {
+        return 1;
+    }
+    if ((s = lookup(name)) == NULL)
+    {
+        for (s = dir; s < &dir[SCRIPT_MAX] && s->name[0] != '\0'; ++s)
+        {
+        }
+        if (s == &dir[SCRIPT_MAX])
+        {
+            return 1;
+        }
+    }
+    def = s;
+    strcpy(defname, name);
+    clen = lineno = nblk = 0;
+    failed = 0;
+    err = NULL;
+    return 0;
+}
+
+int
+script_defining(void)
+{
+    return def != NULL;
+}
+
+void
+script_line(char *line)
+{
+    char *tok[MAXARGS + 1];
+    int ntok, last;
+
+    ++lineno;
+    if ((ntok = split(line, tok)) == 0 || tok[0][0] == '#')
+    {
+        return;
+    }
+
+    last = strcmp(tok[0], ".") == 0;
+    if (failed)
+    {
+        if (last)
+        {
+            def = NULL;             /* partial bytecode is not kept */
+        }
+        return;
+    }
+    if (last)
+    {
+        if (nblk != 0)
+        {
+            err = "missing 'end'";
+        }
+        emit(OP_HALT);
+    }
+    else
+    {
+        compile_line(ntok, tok);
+    }
+
+    if (err != NULL)
+    {
+        myprintf(0, "** Script error, line %d: %s **\n", lineno, err);
+        if (last)
+        {
+            def = NULL;
+        }
+        failed = 1;
+        return;
+    }
+    if (last)
+    {
+        if (def->name[0] != '\0')
+        {
+            drop(def, clen);        /* the old one, new code moves down */
+        }
+        strcpy(def->name, defname);
+        def->off = used;
+        def->len = clen;
+        used += clen;
+        def = NULL;
+    }
+}
+
+int
+script_run(const char *name)
+{
+    const Script *s;
+    const unsigned char *code, *p;
+    unsigned char v;
+    unsigned int sp;
+    long n;
+    int rc;
+
+    if ((s = lookup(name)) == NULL || running)
+    {
+        return 1;
+    }
+    running = 1;
+    memset(var, 0, sizeof(var));
+    code = p = &arena[s->off];
+    for (rc = 0, sp = 0; rc == 0 && !cmd_cancelled(); )
+    {
+        switch (*p++)
+        {
+            case OP_CMD:
+                p = exec_cmd(p, &rc);
+                break;
+            case OP_LET:
+                v = *p++;
+                ncapt = 0;
+                capturing = 1;
+                p = exec_cmd(p, &rc);
+                capturing = 0;
+                var[v] = captured_number();
+                break;
+            case OP_SET:
+                v = *p++;
+                p = eval(p, &var[v]);
+                break;
+            case OP_JZ:
+                p = eval(p, &n);
+                p = n == 0 ? code + get16(p) : p + 2;
+                break;
+            case OP_JMP:
+                p = code + get16(p);
+                break;
+            case OP_LOOP:
+                p = eval(p, &n);
+                if (n <= 0)
+                {
+                    p = code + get16(p);
+                }
+                else
+                {
+                    cnt[sp++] = n;
+                    p += 2;
+                }
+                break;
+            case OP_NEXT:
+                if (--cnt[sp - 1] > 0)
+                {
+                    p = code + get16(p);
+                }
+                else
+                {
+                    --sp;
+                    p += 2;
+                }
+                break;
+            default:                        /* OP_HALT */
+                running = 0;
+                return 0;
+        }
+    }
+    running = 0;
+    return 1;
+}
+
+int
+script_delete(const char *name)
+{
+    Script *s;
+
+    if ((s = lookup(name)) == NULL || s == def)
+    {
+        return 1;
+    }
+    drop(s, 0);
+    return 0;
+}
+
+int
+script_capture(const char *s, unsigned int n)
+{
+    if (!capturing)
+    {
+        return 0;
+    }
+    for (; n != 0 && ncapt < SCRIPT_CAPTURE - 1; --n)
+    {
+        capt[ncapt++] = *s++;
+    }
+    return 1;
+}
+
+MInt
+do_script(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    const Script *s;
+
+    if (argc == 1)
+    {
+        for (s = dir; s < &dir[SCRIPT_MAX]; ++s)
+        {
+            if (s->name[0] != '\0')
+            {
+                myprintf(0, "%-8s %u bytes\n", s->name, s->len);
+            }
+        }
+        myprintf(0, "%u bytes free\n", SCRIPT_ARENA - used);
+        return 0;
+    }
+    if (argc == 3 && strcmp(argv[1], "del") == 0)
+    {
+        return script_delete(argv[2]);
+    }
+    if (argc == 2)
+    {
+        if (script_define(argv[1]) != 0)
+        {
+            conser_puts("** No room for script **\n");
+            return 1;
+        }
+        return 0;
+    }
+    return 1;
+}
+
+MInt
+do_run(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        return 1;
+    }
+    if (lookup(argv[1]) == NULL)
+    {
+        myprintf(0, "Unknown script '%s'\n", argv[1]);
+        return 1;
+    }
+    if (script_run(argv[1]) != 0)
+    {
+        conser_puts("** Script aborted **\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* ------------------------------ End of file ------------------------------ */
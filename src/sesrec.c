@@ -0,0 +1,196 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   sesrec.c
+ *  \brief  Session recorder at the shellser boundary.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stddef.h>
+#include "mytypes.h"
+#include "contick.h"
+#include "sesrec.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/** Worst case of an encoded unsigned long */
+#define VARINT_MAX              10
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+/** Log output, NULL while recording is stopped */
+static SesRecSink sink;
+
+/** Tick of the last flushed record */
+static unsigned long last;
+
+/** Tick and direction of the pending record */
+static unsigned long tick;
+static unsigned char dir;
+
+/**
+ * Pending record. Room for tag and delta ticks is reserved in front of 
+ * payload, so the whole record goes out in one sink call.
+ */
+static unsigned char chunk[1 + VARINT_MAX + SESREC_CHUNK];
+
+/** Number of bytes of pending payload */
+static unsigned int n;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static unsigned int
+put_varint(unsigned char *p, unsigned long v)
+{
+    unsigned int i;
+
+    for (i = 0; v >= 0x80; ++i, v >>= 7)
+    {
+        p[i] = (unsigned char)(v | 0x80);
+    }
+    p[i++] = (unsigned char)v;
+    return i;
+}
+
+/**
+ *  \brief
+ *  Start a new record, flushing the pending one if it belongs to another 
+ *  direction, another tick or it is full.
+ */
+static void
+check_record(unsigned char d)
+{
+    unsigned long now;
+
+    now = contick_now();
+    if (n != 0 && (d != dir || now != tick || n == SESREC_CHUNK))
+    {
+        sesrec_flush();
+    }
+    if (n == 0)
+    {
+        dir = d;
+        tick = now;
+    }
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+sesrec_start(SesRecSink s)
+{
+    unsigned char hdr[5 + VARINT_MAX];
+    unsigned int len;
+
+    sink = NULL;
+    hdr[0] = 'S';
+    hdr[1] = 'R';
+    hdr[2] = 'E';
+    hdr[3] = 'C';
+    hdr[4] = SESREC_VERSION;
+    len = 5 + put_varint(&hdr[5], CONTICK_PERIOD_US);
+    s(hdr, len);
+
+    n = 0;
+    last = contick_now();
+    sink = s;
+}
+
+void
+sesrec_stop(void)
+{
+    sesrec_flush();
+    sink = NULL;
+}
+
+void
+sesrec_flush(void)
+{
+    unsigned char head[1 + VARINT_MAX];
+    unsigned int len, i;
+    unsigned char *p;
+
+    if (sink == NULL || n == 0)
+    {
+        return;
+    }
+
+    head[0] = dir | (unsigned char)(n - 1);
+    len = 1 + put_varint(&head[1], tick - last);
+
+    /* Move the header just in front of payload */
+    p = &chunk[1 + VARINT_MAX - len];
+    for (i = 0; i < len; ++i)
+    {
+        p[i] = head[i];
+    }
+    sink(p, len + n);
+
+    last = tick;
+    n = 0;
+}
+
+void
+sesrec_rx(char c)
+{
+    if (sink == NULL)
+    {
+        return;
+    }
+    check_record(SESREC_TAG_RX);
+    chunk[1 + VARINT_MAX + n++] = (unsigned char)c;
+}
+
+void
+sesrec_tx(const char *s, unsigned int len)
+{
+    if (sink == NULL)
+    {
+        return;
+    }
+    while (len--)
+    {
+        check_record(SESREC_TAG_TX);
+        chunk[1 + VARINT_MAX + n++] = (unsigned char)*s++;
+    }
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,280 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   sesrep.c
+ *  \brief  Replay driver for logs written by sesrec module.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stddef.h>
+#include <time.h>
+#include "mytypes.h"
+#include "sesrec.h"
+#include "sesrep.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/**
+ * Number of polls without any output from the shell after which the next 
+ * received record is released anyway, so a shell that sends less than 
+ * the log does not stall the replay.
+ */
+#define SESREP_STALL            1000
+
+/* ---------------------------- Local data types --------------------------- */
+/** Walks the records of one direction */
+typedef struct Cursor Cursor;
+struct Cursor
+{
+    const unsigned char *p;     /* next record */
+    const unsigned char *data;  /* payload of current record */
+    unsigned int left;          /* bytes left in current record */
+    unsigned long tick;         /* timestamp of current record */
+    unsigned long txbefore;     /* TX bytes logged before current record */
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static const unsigned char *end;
+static unsigned long period;
+static int timed;
+static Cursor rxc, txc;
+static SesRepStat stat;
+static unsigned int idle;
+static struct timespec start;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static const unsigned char *
+get_varint(const unsigned char *p, unsigned long *v)
+{
+    unsigned int shift;
+
+    for (*v = 0, shift = 0; p < end; shift += 7)
+    {
+        *v |= (unsigned long)(*p & 0x7F) << shift;
+        if ((*p++ & 0x80) == 0)
+        {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/**
+ *  \brief
+ *  Move the cursor to the next record of direction dir.
+ *
+ *  \return
+ *  0 if there are no more records of that direction.
+ */
+static int
+next_record(Cursor *c, unsigned char dir)
+{
+    unsigned long delta;
+    unsigned int len;
+    unsigned char tag;
+    const unsigned char *p;
+
+    while (c->p < end)
+    {
+        tag = *c->p;
+        len = (tag & SESREC_TAG_LEN) + 1;
+        if ((p = get_varint(c->p + 1, &delta)) == NULL || p + len > end)
+        {
+            return 0;
+        }
+        c->tick += delta;
+        c->p = p + len;
+        if ((tag & SESREC_TAG_TX) == dir)
+        {
+            c->data = p;
+            c->left = len;
+            return 1;
+        }
+        c->txbefore += len;
+    }
+    return 0;
+}
+
+static unsigned long
+elapsed_usec(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)(now.tv_sec - start.tv_sec) * 1000000UL +
+           (now.tv_nsec - start.tv_nsec) / 1000;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+sesrep_open(const unsigned char *log, unsigned long len, int mode)
+{
+    const unsigned char *p;
+    unsigned long delta;
+    unsigned int n;
+
+    end = log + len;
+    if (len < 6 || log[0] != 'S' || log[1] != 'R' || log[2] != 'E' ||
+        log[3] != 'C' || log[4] != SESREC_VERSION ||
+        (p = get_varint(&log[5], &period)) == NULL)
+    {
+        return SESREP_BAD_HEADER;
+    }
+
+    /* Check every record and count the expected output */
+    stat.expected = 0;
+    for (rxc.p = p; rxc.p < end; rxc.p += n)
+    {
+        n = (*rxc.p & SESREC_TAG_LEN) + 1;
+        if ((rxc.p[0] & SESREC_TAG_TX) != 0)
+        {
+            stat.expected += n;
+        }
+        if ((rxc.p = get_varint(rxc.p + 1, &delta)) == NULL || 
+            rxc.p + n > end)
+        {
+            return SESREP_BAD_RECORD;
+        }
+    }
+
+    rxc.p = txc.p = p;
+    rxc.left = txc.left = 0;
+    rxc.tick = txc.tick = 0;
+    rxc.txbefore = txc.txbefore = 0;
+    next_record(&rxc, SESREC_TAG_RX);
+    next_record(&txc, SESREC_TAG_TX);
+
+    timed = mode == SESREP_TIMED;
+    stat.rx = stat.tx = stat.mismatches = stat.first = 0;
+    idle = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    return SESREP_OK;
+}
+
+MUInt
+sesrep_tstc(void)
+{
+    if (rxc.left == 0)
+    {
+        return 1;
+    }
+    if (stat.tx < rxc.txbefore && ++idle < SESREP_STALL)
+    {
+        return 1;
+    }
+    if (timed && elapsed_usec() < rxc.tick * period)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+MUInt
+sesrep_getc(void)
+{
+    unsigned char c;
+
+    if (rxc.left == 0)
+    {
+        return 0xFF;
+    }
+    c = *rxc.data++;
+    ++stat.rx;
+    if (--rxc.left == 0)
+    {
+        next_record(&rxc, SESREC_TAG_RX);
+    }
+    return c;
+}
+
+void
+sesrep_putc(const char c)
+{
+    idle = 0;
+    if (txc.left != 0)
+    {
+        if (*txc.data++ != (unsigned char)c && stat.mismatches++ == 0)
+        {
+            stat.first = stat.tx;
+        }
+        if (--txc.left == 0)
+        {
+            next_record(&txc, SESREC_TAG_TX);
+        }
+    }
+    else if (stat.mismatches++ == 0)        /* more output than logged */
+    {
+        stat.first = stat.tx;
+    }
+    ++stat.tx;
+}
+
+void
+sesrep_puts(const char *s)
+{
+    while (*s)
+        sesrep_putc(*s++);
+}
+
+int
+sesrep_done(void)
+{
+    return rxc.left == 0;
+}
+
+int
+sesrep_result(SesRepStat *st)
+{
+    *st = stat;
+    st->usec = elapsed_usec();
+    if (stat.tx < stat.expected)            /* less output than logged */
+    {
+        if (st->mismatches++ == 0)
+        {
+            st->first = stat.tx;
+        }
+    }
+    return st->mismatches != 0;
+}
+
+/* ------------------------------ End of file ------------------------------ */
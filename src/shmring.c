@@ -0,0 +1,254 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   shmring.c
+ *  \brief  Shell transport over a pair of rings in POSIX shared memory.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The producer publishes data with a release store of head and the 
+ *  consumer frees room with a release store of tail, each one reads the 
+ *  other index with an acquire load.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include "shmring.h"
+
+#if SHMRING || defined(__TEST__)
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* ----------------------------- Local macros ------------------------------ */
+#define LOAD(p)                 __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define STORE(p, v)             __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+/* ------------------------------- Constants ------------------------------- */
+#define CACHE_LINE              64
+
+/* ---------------------------- Local data types --------------------------- */
+typedef struct Ring Ring;
+struct Ring
+{
+    uint32_t head;
+    unsigned char pad0[CACHE_LINE - sizeof(uint32_t)];
+    uint32_t tail;
+    unsigned char pad1[CACHE_LINE - sizeof(uint32_t)];
+    unsigned char data[SHMRING_SIZE];
+};
+
+typedef struct Region Region;
+struct Region
+{
+    uint32_t magic;
+    uint32_t size;
+    uint32_t peers;
+    unsigned char pad[CACHE_LINE - 3 * sizeof(uint32_t)];
+    Ring in;
+    Ring out;
+};
+
+struct ShmLink
+{
+    Region *reg;
+    Ring *rd;
+    Ring *wr;
+    Transport tr;
+    char *name;                     /* to unlink, shell side only */
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+ShmLink *
+shmring_open(const char *name, int side)
+{
+    ShmLink *link;
+    Region *reg;
+    int fd;
+
+    if (side == SHMRING_SHELL)
+    {
+        shm_unlink(name);
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0 && ftruncate(fd, sizeof(Region)) != 0)
+        {
+            close(fd);
+            shm_unlink(name);
+            fd = -1;
+        }
+    }
+    else
+    {
+        fd = shm_open(name, O_RDWR, 0);
+    }
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    reg = mmap(NULL, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, 
+               fd, 0);
+    close(fd);
+    if (reg == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    if ((link = calloc(1, sizeof(ShmLink))) == NULL)
+    {
+        munmap(reg, sizeof(Region));
+        return NULL;
+    }
+    link->reg = reg;
+    if (side == SHMRING_SHELL)
+    {
+        link->rd = &reg->in;
+        link->wr = &reg->out;
+        link->name = strdup(name);
+        reg->size = SHMRING_SIZE;
+        STORE(&reg->magic, SHMRING_MAGIC);
+    }
+    else
+    {
+        if (LOAD(&reg->magic) != SHMRING_MAGIC || reg->size != SHMRING_SIZE)
+        {
+            munmap(reg, sizeof(Region));
+            free(link);
+            return NULL;
+        }
+        link->rd = &reg->out;
+        link->wr = &reg->in;
+        __atomic_fetch_add(&reg->peers, 1, __ATOMIC_RELEASE);
+    }
+    link->tr.read = shmring_read;
+    link->tr.write = shmring_write;
+    link->tr.poll = shmring_poll;
+    link->tr.attached = shmring_attached;
+    link->tr.ctx = link;
+    return link;
+}
+
+void
+shmring_close(ShmLink *link)
+{
+    if (link->name == NULL)
+    {
+        __atomic_fetch_sub(&link->reg->peers, 1, __ATOMIC_RELEASE);
+    }
+    munmap(link->reg, sizeof(Region));
+    if (link->name != NULL)
+    {
+        shm_unlink(link->name);
+        free(link->name);
+    }
+    free(link);
+}
+
+const Transport *
+shmring_transport(ShmLink *link)
+{
+    return &link->tr;
+}
+
+unsigned int
+shmring_read(void *link, void *buf, unsigned int len)
+{
+    Ring *r;
+    uint32_t head, tail, n, i, k;
+
+    r = ((ShmLink *)link)->rd;
+    head = LOAD(&r->head);
+    tail = r->tail;
+    if ((n = head - tail) > len)
+    {
+        n = len;
+    }
+    i = tail & (SHMRING_SIZE - 1);
+    k = SHMRING_SIZE - i < n ? SHMRING_SIZE - i : n;
+    memcpy(buf, &r->data[i], k);
+    memcpy((unsigned char *)buf + k, r->data, n - k);
+    STORE(&r->tail, tail + n);
+    return n;
+}
+
+unsigned int
+shmring_write(void *link, const void *buf, unsigned int len)
+{
+    Ring *r;
+    uint32_t head, tail, n, i, k;
+
+    r = ((ShmLink *)link)->wr;
+    tail = LOAD(&r->tail);
+    head = r->head;
+    if ((n = SHMRING_SIZE - (head - tail)) > len)
+    {
+        n = len;
+    }
+    i = head & (SHMRING_SIZE - 1);
+    k = SHMRING_SIZE - i < n ? SHMRING_SIZE - i : n;
+    memcpy(&r->data[i], buf, k);
+    memcpy(r->data, (const unsigned char *)buf + k, n - k);
+    STORE(&r->head, head + n);
+    return n;
+}
+
+int
+shmring_poll(void *link)
+{
+    Ring *r;
+
+    r = ((ShmLink *)link)->rd;
+    return LOAD(&r->head) != r->tail;
+}
+
+int
+shmring_attached(void *link)
+{
+    return LOAD(&((ShmLink *)link)->reg->peers) != 0;
+}
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
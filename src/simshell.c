@@ -53,12 +53,23 @@
 #include "formats.h"
 #include "console.h"
 #include "contick.h"
+#include "simtrace.h"
+#include "cmdarg.h"
+#include "simshell.h"
+#include "tahead.h"
+#include "cmdcache.h"
+#include "tagreq.h"
+#include "conabort.h"
+#include "deadline.h"
+#include "script.h"
+#include "conlog.h"
+#include "vchan.h"
+#include "cmdreg.h"
+#include "stackhw.h"
+#include "result.h"
 
 /* ----------------------------- Local macros ------------------------------ */
 /* ------------------------------- Constants ------------------------------- */
-/** Define the size of console buffer */
-#define CBSIZE                  32
-
 /** Length of prompt string */
 #define PROMPT_LEN              sizeof(prompt)
 
@@ -86,6 +97,18 @@ static const char erase_seq[] = "\b \b";
 /** Used to store the command's arguments */
 static char *argv[MAXARGS + 1];
 
+/** 
+ * Used to store the typed command's arguments, one set per nesting 
+ * level so a command run by a handler leaves the handler's ones alone.
+ */
+static CMD_VAL vals[SIMSHELL_DEPTH][MAXARGS + 1];
+
+/** Nesting level of running handlers */
+static unsigned char depth;
+
+/** Line mode, no echo nor redraws unless LINE_EDIT */
+static unsigned char linemode;
+
 /**
  * Used to maintain the input char from attached serial channel
  */
@@ -100,6 +123,47 @@ static unsigned int col;
 /** Pointer to console buffer */
 static char *p;
 
+#if INCPARSE
+/** Arguments of the line being typed, offsets of first and last char */
+static unsigned char tbeg[MAXARGS], tend[MAXARGS];
+
+/** Number of arguments so far */
+static unsigned int ntok;
+
+/** Last argument still being typed */
+static unsigned char open;
+
+/** Arguments describe console buffer, not overflowed nor overwritten */
+static unsigned char lexed;
+
+/** Built-in command named by first argument, NULL if none */
+static const CMD_TABLE *first;
+#endif
+
+#if BUDGET
+/** Handler that returned CMD_MORE, with its arguments */
+static const CMD_TABLE *more_cmd;
+static unsigned int more_argc;
+static char **more_argv;
+#if CMDREG
+static unsigned int more_tok;
+#endif
+
+/** Budget of current slice, 0 if unlimited */
+static unsigned long slice_start, slice_ticks, slice_tx;
+static unsigned int slice_bytes;
+
+/** Handler being called again */
+static unsigned char resumed;
+
+unsigned long simshell_tx;
+#endif
+
+#if CONLOG
+/** Prompt and partial input, as shown on console */
+static char redraw[sizeof(prompt) + 8 * CBSIZE];
+#endif
+
 /**
  * If CONFIG_CMD_TOUT is defined and command timer elapsed, command shell is 
  * aborted.
@@ -117,15 +181,57 @@ print_prompt(void)
 {
     n = 0;
     p = console_buffer;
+#if INCPARSE
+    ntok = 0;
+    open = 0;
+    first = NULL;
+    lexed = 1;
+#endif
+#if RAWLINE
+    if (linemode == LINE_TAGGED)    /* responses are framed instead */
+    {
+        col = 0;
+        return;
+    }
+#endif
     if (prompt != NULL)
     {
         shellser_puts(prompt);
         col = PROMPT_LEN;
+        SIMTRACE_EVT(TRC_PROMPT, 0);
         return;
     }
     col = 0;
 }
 
+/**
+ *  \brief
+ *  Echo input on console, unless raw line mode is set.
+ */
+static void
+echo_puts(const char *s)
+{
+#if RAWLINE
+    if (linemode != LINE_EDIT)
+    {
+        return;
+    }
+#endif
+    shellser_puts(s);
+}
+
+static void
+echo_putc(char c)
+{
+#if RAWLINE
+    if (linemode != LINE_EDIT)
+    {
+        return;
+    }
+#endif
+    shellser_putc(c);
+}
+
 /**
  *  \brief
  *  Delete one character of console. Check '\t' character.
@@ -138,10 +244,17 @@ delete_char(char *buffer, char *p, unsigned int *colp, unsigned int *np)
 
     if (*np == 0)
     {
-        shellser_putc('\a');
+        echo_putc('\a');
         return p;
     }
 
+#if RAWLINE
+    if (linemode != LINE_EDIT)
+    {
+        --(*np);
+        return p - 1;
+    }
+#endif
     if (*(--p) == '\t')
     {
         while (*colp > PROMPT_LEN) /* delete whole line on console */
@@ -171,6 +284,144 @@ delete_char(char *buffer, char *p, unsigned int *colp, unsigned int *np)
 }
 #endif
 
+#if INCPARSE
+/**
+ *  \brief
+ *  Look up the first argument in the built-in table. The argument is 
+ *  the tail of console buffer.
+ */
+static void
+lex_lookup(void)
+{
+    *p = '\0';
+    first = find_tbl_cmd(console_buffer + tbeg[0]);
+}
+
+/**
+ *  \brief
+ *  Ring the bell if the finished first argument names no command.
+ */
+static void
+lex_check(void)
+{
+#if CMDREG
+    unsigned int tok;
+    const CMD_TABLE *cmdtp;
+#endif
+
+    if (first != NULL)
+    {
+        return;
+    }
+#if SCRIPT
+    /* Lines of a script being defined start with its own keywords */
+    if (script_defining())
+    {
+        return;
+    }
+#endif
+#if CMDREG
+    tok = cmdreg_read_lock();
+    *p = '\0';
+    cmdtp = cmdreg_find(console_buffer + tbeg[0]);
+    cmdreg_read_unlock(tok);
+    if (cmdtp != NULL)
+    {
+        return;
+    }
+#endif
+    echo_putc('\a');
+}
+
+/**
+ *  \brief
+ *  Account the character just appended to console buffer.
+ */
+static void
+lex_putc(char c)
+{
+    unsigned int at = n - 1;
+
+    if (c == ' ' || c == '\t')
+    {
+        if (open)
+        {
+            open = 0;
+            tend[ntok - 1] = (unsigned char)at;
+            if (ntok == 1)
+            {
+                lex_check();
+            }
+        }
+        return;
+    }
+    if (!open)
+    {
+        if (ntok == MAXARGS)
+        {
+            lexed = 0;              /* too many, left to parse_line() */
+            return;
+        }
+        open = 1;
+        tbeg[ntok++] = (unsigned char)at;
+    }
+    if (ntok == 1)
+    {
+        lex_lookup();
+    }
+}
+
+/**
+ *  \brief
+ *  Drop arguments, or part of them, erased from console buffer.
+ */
+static void
+lex_trim(void)
+{
+    while (ntok > 0 && tbeg[ntok - 1] >= n)
+    {
+        --ntok;
+        open = 0;
+    }
+    if (ntok > 0 && !open && tend[ntok - 1] >= n)
+    {
+        open = 1;                   /* its separator was erased */
+    }
+    if (ntok == 0)
+    {
+        first = NULL;
+    }
+    else if (ntok == 1 && open)
+    {
+        lex_lookup();
+    }
+}
+
+/**
+ *  \brief
+ *  Split console buffer at the arguments found while typing it.
+ *
+ *  \return
+ *  Number of arguments.
+ */
+static unsigned int
+lex_split(char *argv[])
+{
+    unsigned int i;
+
+    for (i = 0; i < ntok; ++i)
+    {
+        argv[i] = console_buffer + tbeg[i];
+        if (i + 1 < ntok || !open)
+        {
+            console_buffer[tend[i]] = '\0';
+        }
+    }
+    argv[i] = NULL;
+    return i;
+}
+#endif
+
 /**
  *  \brief
  *  Every received character from attached serial channel is parsed on-line.
@@ -190,7 +441,8 @@ process_in_char(char c)
         case '\r':                                  /* Enter */
         case '\n':
             *p = '\0';
-            shellser_puts("\r\n");
+            echo_puts("\r\n");
+            SIMTRACE_EVT(TRC_LINE, p - console_buffer);
             return p - console_buffer;
         case 0x03:                                  /* ^C - abort */
             return -CTRL_C;
@@ -198,11 +450,14 @@ process_in_char(char c)
 #if DELETE_CHAR
             while (col > PROMPT_LEN)
             {
-                shellser_puts(erase_seq);
+                echo_puts(erase_seq);
                 --col;
             }
             p = console_buffer;
             n = 0;
+#if INCPARSE
+            lex_trim();
+#endif
 #endif
             return -PARSING;
         case 0x17:                                  /* ^W - erase word  */
@@ -210,19 +465,25 @@ process_in_char(char c)
             p = delete_char(console_buffer, p, &col, &n);
             while (n > 0 && *p != ' ')
                 p = delete_char(console_buffer, p, &col, &n);
+#if INCPARSE
+            lex_trim();
+#endif
 #endif
             return -PARSING;
         case 0x08:                                  /* ^H  - backspace	*/
         case 0x7F:                                  /* DEL - backspace	*/
 #if DELETE_CHAR
             p = delete_char(console_buffer, p, &col, &n);
+#if INCPARSE
+            lex_trim();
+#endif
 #endif
             return -PARSING;
         default:
             /* Must be a normal character then */
             if (n < CBSIZE - 2)
             {
-                if (c == '\t')                      /* Expand TABs */
+                if (c == '\t' && linemode == LINE_EDIT) /* Expand TABs */
                 {
                     shellser_puts(tab_seq + (col & 7));
                     col += 8 - (col & 7);
@@ -230,14 +491,17 @@ process_in_char(char c)
                 else                                /* Echo input	*/
                 {
                     ++col;
-                    shellser_putc(c);
+                    echo_putc(c);
                 }
                 *p++ = c;
                 ++n;
+#if INCPARSE
+                lex_putc(c);
+#endif
             }
             else                                    /* Buffer full */
             {
-                shellser_putc('\a');
+                echo_putc('\a');
             }
             return -PARSING;
     }
@@ -303,22 +567,232 @@ parse_line(char *line, char *argv[])
     return nargs;
 }
 
+/**
+ *  \brief
+ *  Call the command handler, the typed one if the command has it.
+ *
+ *  Handlers may run other commands, e.g. scripts do. Cache, type-ahead 
+ *  and deadline apply to the outermost one only.
+ *
+ *  A handler that returns CMD_MORE is not cached: its output is spread 
+ *  over slices, with other output in between, so the capture started by 
+ *  the first slice is dropped and resumed slices skip the cache. Deadline,
+ *  type-ahead and stack marks are armed again for every slice, as each 
+ *  one runs the handler on its own.
+ *
+ *  \return
+ *  Return code of handler.
+ */
+static MInt
+call_command(const CMD_TABLE *cmdtp, unsigned int argc, char *argv[])
+{
+    MInt rc;
+#if DEADLINE
+    unsigned long over;
+#endif
+
+    if (depth++ != 0)
+    {
+        SIMTRACE_CMD(TRC_ENTER, cmdtp);
+        if (cmdtp->ext != NULL && cmdtp->ext->run != NULL)
+        {
+            rc = (cmdtp->ext->run)(cmdtp, argc, vals[depth - 1]);
+        }
+        else
+        {
+            rc = (cmdtp->cmd)(cmdtp, argc, argv);
+        }
+        SIMTRACE_EVT(TRC_EXIT, rc);
+        --depth;
+        return rc;
+    }
+
+#if CMDCACHE
+    if (
+#if BUDGET
+        !resumed &&
+#endif
+        cmdtp->ext != NULL && cmdtp->ext->ttl != 0 &&
+        cmdcache_begin(cmdtp, argc, argv))
+    {
+        --depth;
+        return 0;                           /* served from cache */
+    }
+#endif
+    SIMTRACE_CMD(TRC_ENTER, cmdtp);
+#if TAHEAD
+    tahead_busy(1);
+#endif
+#if DEADLINE
+    deadline_start(cmdtp->ext != NULL && cmdtp->ext->deadline != 0 ?
+                   cmdtp->ext->deadline : DEADLINE_DEFAULT);
+#endif
+#if BUDGET
+    if (!resumed)                   /* a resumed handler goes on with it */
+#endif
+    {
+        result_reset();
+    }
+#if STACKHW
+    stackhw_paint();
+#endif
+    if (cmdtp->ext != NULL && cmdtp->ext->run != NULL)
+    {
+        rc = (cmdtp->ext->run)(cmdtp, argc, vals[depth - 1]);
+    }
+    else
+    {
+        rc = (cmdtp->cmd)(cmdtp, argc, argv);
+    }
+#if STACKHW
+    stackhw_measure(cmdtp);
+#endif
+#if DEADLINE
+    if ((over = deadline_stop()) != 0)
+    {
+#ifdef PRINT_FORMATS
+        myprintf(0, "** '%s' overran its deadline by %lu ticks **\n",
+                 cmdtp->name, over);
+#else
+        shellser_puts("** Deadline overrun **\n");
+#endif
+    }
+#endif
+#if TAHEAD
+    tahead_busy(0);
+#endif
+    SIMTRACE_EVT(TRC_EXIT, rc);
+#if CMDCACHE
+    cmdcache_end(rc);                       /* CMD_MORE drops the capture */
+#endif
+    --depth;
+    return rc;
+}
+
+/**
+ *  \brief
+ *  Go down to the command of a group named by the following arguments.
+ *
+ *  \return
+ *  Command found, still a group if they do not name one of it. The 
+ *  arguments consumed are left in sub.
+ */
+static const CMD_TABLE *
+descend(const CMD_TABLE *cmdtp, unsigned int argc, char *argv[],
+        unsigned int *sub)
+{
+    const CMD_TABLE *grp;
+
+    for (*sub = 0; cmd_is_group(cmdtp) && *sub + 1 < argc &&
+         (grp = find_cmd_in(cmdtp->ext->sub, argv[*sub + 1])) != NULL; )
+    {
+        cmdtp = grp;
+        ++*sub;
+    }
+    return cmdtp;
+}
+
+/**
+ *  \brief
+ *  Check the arguments of a found command and call it.
+ *
+ *  \return
+ *  0 - command executed
+ *  1 - handler returned CMD_MORE, to be called again
+ *  -1 - not executed (too many or bad args) or it failed
+ */
+static int
+exec_command(const CMD_TABLE *cmdtp, unsigned int argc, char *argv[])
+{
+    MInt rc;
+
+    /* A group has no handler of its own */
+    if (cmd_is_group(cmdtp))
+    {
+        list_cmds(cmdtp->ext->sub);
+        return -1;
+    }
+
+    if (depth == SIMSHELL_DEPTH)
+    {
+#ifdef PRINT_FORMATS
+        myprintf(0, "** Nested too deep (max. %d) **\n", SIMSHELL_DEPTH);
+#endif
+        return -1;
+    }
+
+    /* Found - Check max args */
+    if (argc > cmdtp->maxargs)
+    {
+#ifdef PRINT_FORMATS
+        myprintf(0, "Usage:\n%s\n", cmdtp->usage);
+#endif
+        return -1;
+    }
+
+    /* Typed arguments - Check them against the command's schema */
+    if (cmdtp->ext != NULL && cmdtp->ext->run != NULL &&
+        (rc = cmdarg_parse(cmdtp->ext, argc, argv, vals[depth])) !=
+        CMDARG_OK)
+    {
+#ifdef PRINT_FORMATS
+        if (rc > 0)
+        {
+            myprintf(0, "** Bad argument '%s', expected %s **\n", argv[rc],
+                     cmdtp->ext->args[rc - 1].name);
+        }
+        myprintf(0, "Usage:\n%s\n", cmdtp->usage);
+#endif
+        return -1;
+    }
+
+    /* OK - Call function to do the command */
+    if ((rc = call_command(cmdtp, argc, argv)) != 0)
+    {
+#if BUDGET
+        if (rc == CMD_MORE)
+        {
+            return 1;
+        }
+#endif
+#ifdef PRINT_FORMATS
+        myprintf(0, "Usage:\n%s\n", cmdtp->usage);
+#endif
+        return -1;
+    }
+    return 0;
+}
+
 /**
  *  \brief
  *  Get and find the actual command. If found it, then get all arguments 
  *  and pass it to properly callback function.
  *
  *  \return
- *	0,1	- command executed.
+ *	0	- command executed.
+ *	1	- command to be resumed, see CMD_MORE
  *	-1  - not executed (unrecognized or too many args)
  *  If cmd is NULL or "" or longer than CBSIZE-1 it is considered unrecognized
  */
 static int
-run_command(char *cmd)
+run_line(char *cmd)
 {
     const CMD_TABLE *cmdtp;
     char *str = cmd;
-    unsigned int argc;
+    unsigned int argc, sub;
+    int rc;
+#if CMDREG
+    unsigned int tok;
+#endif
+
+#if SCRIPT
+    /* Lines of a script being defined are not commands */
+    if (script_defining())
+    {
+        script_line(cmd);
+        return 0;
+    }
+#endif
 
     /* Empty command */
     if (!cmd || !*cmd)
@@ -326,47 +800,171 @@ run_command(char *cmd)
         return -1;
     }
 
-    if (strlen(cmd) >= CBSIZE)
+    cmdtp = NULL;
+#if INCPARSE
+    if (lexed && cmd == console_buffer)
+    {
+        /* Already split and looked up while it was typed */
+        argc = lex_split(argv);
+        cmdtp = first;
+    }
+    else
+#endif
+    {
+        if (strlen(cmd) >= CBSIZE)
+        {
+            shellser_puts("## Command too long!\n");
+            return -1;
+        }
+
+        /* Extract arguments */
+        argc = parse_line(str, argv);
+    }
+    SIMTRACE_EVT(TRC_PARSE, argc);
+
+    if (argc == 0)
     {
-        shellser_puts("## Command too long!\n");
         return -1;
     }
 
-    /* Extract arguments */
-    argc = parse_line(str, argv);
+#if CMDREG
+    /* Registered entries are not reclaimed until the command returns */
+    tok = cmdreg_read_lock();
+#endif
 
     /* Look up command in command table */
-    if ((cmdtp = find_cmd(argv[0])) == NULL)
+    if (cmdtp == NULL && (cmdtp = find_cmd(argv[0])) == NULL)
     {
+        SIMTRACE_EVT(TRC_MISS, 0);
 #ifdef PRINT_FORMATS
         myprintf(0, "Unknown command '%s' - try 'help'\n", argv[0]);
 #else
         shellser_puts("Unknown command - try 'help'\n");
 #endif
-        return -1;  /* Give up after bad command */
+        rc = -1;    /* Give up after bad command */
     }
-
-    /* Found - Check max args */
-    if (argc > cmdtp->maxargs)
+    else
     {
+        cmdtp = descend(cmdtp, argc, argv, &sub);
+        if (cmd_is_group(cmdtp))
+        {
 #ifdef PRINT_FORMATS
-        myprintf(0, "Usage:\n%s\n", cmdtp->usage);
+            if (sub + 1 < argc)
+            {
+                myprintf(0, "Unknown command '%s' in '%s'\n", argv[sub + 1],
+                         cmdtp->name);
+            }
 #endif
+            list_cmds(cmdtp->ext->sub);
+            rc = -1;
+        }
+        else
+        {
+            SIMTRACE_CMD(TRC_HIT, cmdtp);
+            rc = exec_command(cmdtp, argc - sub, argv + sub);
+        }
+    }
+
+#if BUDGET
+    if (rc == 1)
+    {
+        /* Arguments stay in console buffer until it finishes */
+        more_cmd = cmdtp;
+        more_argc = argc - sub;
+        more_argv = argv + sub;
+#if CMDREG
+        more_tok = tok;             /* it keeps the read section */
+#endif
+        return 1;
+    }
+#endif
+#if CMDREG
+    cmdreg_read_unlock(tok);
+#endif
+    return rc < 0 ? -1 : 0;
+}
+
+/**
+ *  \brief
+ *  Run a line typed on console. In tagged line mode, the line carries a 
+ *  tag to frame its response, and it is always answered.
+ *
+ *  \return
+ *  0 - command executed and new prompt printed, or to be resumed
+ *  -1 - not executed, see run_line()
+ */
+static int
+run_command(char *cmd)
+{
+    int rc;
+
+#if TAGREQ
+    if (linemode == LINE_TAGGED)
+    {
+        if (cmd && *cmd && (tagreq_begin(&cmd) == 0))
+        {
+            if ((rc = run_line(cmd)) == 1)
+            {
+                return 0;           /* answered once it finishes */
+            }
+            tagreq_end(rc);
+        }
+        print_prompt();
+        return 0;
+    }
+#endif
+    if ((rc = run_line(cmd)) < 0)
+    {
         return -1;
     }
+    if (rc == 0)
+    {
+        print_prompt();
+    }
+    return 0;
+}
 
-    /* OK - Call function to do the command */
-    if ((cmdtp->cmd)(cmdtp, argc, argv) != 0)
+/**
+ *  \brief
+ *  Call again the handler that returned CMD_MORE. Once it finishes, its 
+ *  line is completed as run_command() does.
+ */
+#if BUDGET
+static void
+resume(void)
+{
+    const CMD_TABLE *cmdtp;
+    int rc;
+
+    resumed = 1;
+    rc = call_command(more_cmd, more_argc, more_argv);
+    resumed = 0;
+    if (rc == CMD_MORE)
+    {
+        return;
+    }
+
+    cmdtp = more_cmd;
+    more_cmd = NULL;
+#if CMDREG
+    cmdreg_read_unlock(more_tok);
+#endif
+    if (rc != 0)
     {
 #ifdef PRINT_FORMATS
         myprintf(0, "Usage:\n%s\n", cmdtp->usage);
 #endif
-        return -1;
+        rc = -1;
     }
-
+#if TAGREQ
+    if (linemode == LINE_TAGGED)
+    {
+        tagreq_end(rc);
+    }
+#endif
     print_prompt();
-    return 0;
 }
+#endif
 
 /**
  *  \brief
@@ -381,8 +979,11 @@ static unsigned int
 do_console(void)
 {
     int r;
+    char c;
 
-    if (((r = process_in_char(shellser_getc())) >= 0) &&
+    c = shellser_getc();
+    SIMTRACE_EVT(TRC_RX, c);
+    if (((r = process_in_char(c)) >= 0) &&
         (run_command(console_buffer) < 0))
     {
         print_prompt();
@@ -391,27 +992,228 @@ do_console(void)
     return r == -CTRL_C;
 }
 
-/* ---------------------------- Global functions --------------------------- */
 /**
  *  \brief
- *  Entry point to use the command shell. Each received character from 
- *  attached serial channel is parsed on-line.
+ *  Dispatch the oldest line of type-ahead queue. Once the queue has only 
+ *  a line in progress, it is moved to console buffer to go on editing it.
+ */
+#if TAHEAD
+static void
+do_typeahead(void)
+{
+    char line[CBSIZE];
+    int len, i;
+
+    /* Input still arriving goes behind the queued lines */
+    tahead_fill();
+
+    if (tahead_get(console_buffer) >= 0)
+    {
+#if INCPARSE
+        lexed = 0;                          /* not typed, to be parsed */
+#endif
+        echo_puts(console_buffer);          /* echo it after the prompt */
+        echo_puts("\r\n");
+        if (run_command(console_buffer) < 0)
+        {
+            print_prompt();
+        }
+        return;
+    }
+
+    len = tahead_partial(line);
+    for (i = 0; i < len; ++i)
+    {
+        process_in_char(line[i]);
+    }
+}
+#endif
+
+/**
+ *  \brief
+ *  Print pending log records above the line being typed. The prompt line 
+ *  is blanked, records are printed and then the prompt and partial input 
+ *  are redrawn in a single write.
+ */
+#if CONLOG && !VCHAN
+static void
+print_above_line(void)
+{
+    char rec[CONLOG_LEN];
+    char *d;
+    const char *s;
+    unsigned int i, c;
+
+    shellser_putc('\r');
+    for (i = col; i >= 8; i -= 8)
+    {
+        shellser_puts(tab_seq);
+    }
+    shellser_puts(tab_seq + 8 - i);
+    shellser_putc('\r');
+
+    while (conlog_get(rec) >= 0)
+    {
+        shellser_puts(rec);
+        shellser_puts("\r\n");
+    }
+
+    /* TABs are expanded the same way they were echoed */
+    strcpy(redraw, prompt);
+    d = redraw + sizeof(prompt) - 1;
+    for (s = console_buffer, c = PROMPT_LEN; s < p; ++s)
+    {
+        if (*s == '\t')
+        {
+            for (i = 8 - (c & 7); i != 0; --i, ++c)
+            {
+                *d++ = ' ';
+            }
+        }
+        else
+        {
+            *d++ = *s;
+            ++c;
+        }
+    }
+    *d = '\0';
+    shellser_puts(redraw);
+}
+#endif
+
+/**
+ *  \brief
+ *  Send pending log records. A host client in raw line mode gets them 
+ *  as they are, with VCHAN they go to the log channel and otherwise they 
+ *  are printed above the line being typed.
+ */
+#if CONLOG
+static void
+do_conlog(void)
+{
+#if RAWLINE || VCHAN
+    char rec[CONLOG_LEN];
+#endif
+#if VCHAN
+    int n;
+#endif
+
+#if RAWLINE
+    /* Host client keeps the line, records go out as they are */
+    if (linemode != LINE_EDIT)
+    {
+        while (conlog_get(rec) >= 0)
+        {
+            shellser_puts(rec);
+            shellser_puts("\r\n");
+        }
+        return;
+    }
+#endif
+#if VCHAN
+    /* Logs have a channel of their own, the console is left alone */
+    while ((n = conlog_get(rec)) >= 0)
+    {
+        rec[n] = '\n';
+        vchan_write(VCHAN_LOG, rec, n + 1);
+    }
+#else
+    print_above_line();
+#endif
+}
+#endif
+
+/**
+ *  \brief
+ *  Handle ^C taken out of band. The handler was already cancelled, the 
+ *  line being typed is abandoned and, by policy, pending input dropped.
+ */
+#if CONABORT
+static void
+do_abort(void)
+{
+#if CONABORT_FLUSH
+    while (shellser_tstc() == 0)
+    {
+        (void)shellser_getc();
+    }
+#if TAHEAD
+    tahead_put(0x03);                       /* discard queued lines */
+#endif
+#endif
+#if BUDGET
+    if (more_cmd != NULL)                   /* give up resuming it */
+    {
+        more_cmd = NULL;
+#if CMDREG
+        cmdreg_read_unlock(more_tok);
+#endif
+#if TAGREQ
+        if (linemode == LINE_TAGGED)
+        {
+            tagreq_end(-1);
+        }
+#endif
+        print_prompt();
+        return;
+    }
+#endif
+    if (n != 0)
+    {
+        echo_puts("^C\r\n");
+        print_prompt();
+    }
+}
+#endif
+
+/**
+ *  \brief
+ *  Do the next piece of work of the shell, if any.
  *
- *  If CONFIG_CMD_TOUT is defined and command timer elapsed, returns timeout 
- *  and command shell is aborted.
+ *  \return
+ *  1 if something was done, 0 if idle.
  */
-int 
-simshell_process(int c)
+static int
+step(void)
 {
+#if CONABORT
+    if (conabort_take())
+    {
+        do_abort();
+        return 1;
+    }
+#endif
+#if BUDGET
+    if (more_cmd != NULL)
+    {
+        resume();
+        return 1;
+    }
+#endif
+#if TAHEAD
+    if (tahead_pending())
+    {
+        abort_shell = 0;
+        do_typeahead();
+        return 1;
+    }
+#endif
     if (shellser_tstc())
     {
+#if CONLOG
+        if (conlog_pending())
+        {
+            do_conlog();
+            return 1;
+        }
+#endif
 #if CONFIG_CMD_TOUT
         if (abort_shell && is_cmd_timeout())
         {
             exit(0);
         }
 #endif
-        return;
+        return 0;
     }
     else
     {
@@ -421,8 +1223,112 @@ simshell_process(int c)
             exit(0);
         }
     }
+    return 1;
+}
+
+#if BUDGET
+/**
+ *  \brief
+ *  True once the budget of current slice is spent.
+ */
+static int
+slice_over(void)
+{
+    return (slice_bytes != 0 && simshell_tx - slice_tx >= slice_bytes) ||
+           (slice_ticks != 0 && SIMSHELL_NOW() - slice_start >= slice_ticks);
+}
+#endif
+
+/* ---------------------------- Global functions --------------------------- */
+/**
+ *  \brief
+ *  Entry point to use the command shell. Each received character from 
+ *  attached serial channel is parsed on-line.
+ *
+ *  If CONFIG_CMD_TOUT is defined and command timer elapsed, returns timeout 
+ *  and command shell is aborted.
+ */
+int 
+simshell_process(int c)
+{
+    step();
+    return 0;
+}
+
+#if BUDGET
+int
+simshell_slice(unsigned long ticks, unsigned int bytes)
+{
+    int more;
+
+    slice_start = SIMSHELL_NOW();
+    slice_ticks = ticks;
+    slice_tx = simshell_tx;
+    slice_bytes = bytes;
+
+    while (step() && !slice_over())
+        ;
+    slice_ticks = slice_bytes = 0;  /* plain calls are not limited */
+
+    more = more_cmd != NULL || shellser_tstc() == 0;
+#if TAHEAD
+    more = more || tahead_pending();
+#endif
+#if CONLOG
+    more = more || conlog_pending();
+#endif
+    return more ? SIMSHELL_MORE : SIMSHELL_IDLE;
+}
+#endif
+
+int
+cmd_yield(void)
+{
+#if BUDGET
+    return depth == 1 && slice_over();
+#else
+    return 0;
+#endif
+}
+
+int
+cmd_resumed(void)
+{
+#if BUDGET
+    return resumed && depth == 1;
+#else
+    return 0;
+#endif
 }
 
+/**
+ *  \brief
+ *  Run a command already looked up and split into arguments, going 
+ *  down a group to the command named by them.
+ */
+int
+simshell_exec(const CMD_TABLE *cmdtp, int argc, char *argv[])
+{
+    unsigned int sub;
+
+    cmdtp = descend(cmdtp, argc, argv, &sub);
+    return exec_command(cmdtp, argc - sub, argv + sub);
+}
+
+#if RAWLINE
+void
+simshell_set_linemode(int mode)
+{
+    linemode = (unsigned char)mode;
+}
+
+int
+simshell_get_linemode(void)
+{
+    return linemode;
+}
+#endif
+
 /**
  *  \brief
  *  It initializes this module.
@@ -431,6 +1337,9 @@ void
 simshell_init(void)
 {
     abort_shell = 1;
+#if TAHEAD
+    tahead_init();
+#endif
     print_prompt();
 }
 
@@ -0,0 +1,119 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   simtrace.c
+ *  \brief  Trace ring of command shell.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include "simtrace.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+SimTraceEvt simtrace_ring[SIMTRACE_SIZE];
+volatile unsigned long simtrace_head;
+
+/* ---------------------------- Local variables ---------------------------- */
+/** Events before this one were discarded by simtrace_clear() */
+static unsigned long tail;
+
+static const char *const names[TRC_NUM_EVENTS] =
+{
+    "rx", "line", "parse", "hit", "miss", "enter", "exit", "prompt"
+};
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void
+simtrace_clear(void)
+{
+    tail = simtrace_head;
+}
+
+unsigned int
+simtrace_snapshot(SimTraceEvt *evts, unsigned int max)
+{
+    unsigned long head, first, i;
+    unsigned int n, drop;
+
+    /* The slot of head - SIMTRACE_SIZE is the next one to be written */
+    head = simtrace_head;
+    first = head - tail >= SIMTRACE_SIZE ? head - SIMTRACE_SIZE + 1 : tail;
+    if (head - first > max)
+    {
+        first = head - max;
+    }
+    for (i = first, n = 0; i != head; ++i, ++n)
+    {
+        evts[n] = simtrace_ring[i & (SIMTRACE_SIZE - 1)];
+    }
+
+    /* 
+     * Drop the oldest events if the writer has overwritten them while 
+     * they were being copied, including the one it may be writing now.
+     */
+    head = simtrace_head;
+    if (head - first >= SIMTRACE_SIZE)
+    {
+        drop = (unsigned int)(head - first - SIMTRACE_SIZE + 1);
+        if (drop > n)
+        {
+            drop = n;
+        }
+        for (i = 0; i + drop < n; ++i)
+        {
+            evts[i] = evts[i + drop];
+        }
+        n -= drop;
+    }
+    return n;
+}
+
+const char *
+simtrace_name(unsigned char ev)
+{
+    return ev < TRC_NUM_EVENTS ? names[ev] : "?";
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,162 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   stackhw.c
+ *  \brief  Stack high-water mark of every command.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  stackhw_paint() and the handler are both called from the same frame, 
+ *  so the frame of stackhw_paint() starts where the handler's does. That 
+ *  address, taken by __builtin_frame_address(), is the base of the 
+ *  measure. The painted region leaves GAP 
+ *  bytes below it for the frame of stackhw_paint() itself.
+ *
+ *      base                    top of handler frame
+ *      base - GAP              top of painted region
+ *      base - STACKHW_DEPTH    bottom of painted region
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "mytypes.h"
+#include "conser.h"
+#include "formats.h"
+#include "stackhw.h"
+
+#if STACKHW
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/** Room for the frame of stackhw_paint() */
+#define GAP                     64
+
+/* ---------------------------- Local data types --------------------------- */
+typedef struct StackHw StackHw;
+struct StackHw
+{
+    const CMD_TABLE *cmdtp;
+    unsigned int worst;
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static volatile unsigned char *base;
+static StackHw marks[STACKHW_MAX];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+STACKHW_NOINLINE void
+stackhw_paint(void)
+{
+    volatile unsigned char *p;
+
+    base = (volatile unsigned char *)__builtin_frame_address(0);
+    for (p = base - STACKHW_DEPTH; p < base - GAP; ++p)
+    {
+        *p = STACKHW_PATTERN;
+    }
+}
+
+STACKHW_NOINLINE unsigned int
+stackhw_measure(const CMD_TABLE *cmdtp)
+{
+    volatile unsigned char *p;
+    StackHw *m, *slot;
+    unsigned int used;
+
+    for (p = base - STACKHW_DEPTH; p < base - GAP && *p == STACKHW_PATTERN;
+         ++p)
+    {
+    }
+    used = base - p;
+
+    for (m = marks, slot = NULL; m < &marks[STACKHW_MAX]; ++m)
+    {
+        if (m->cmdtp == cmdtp)
+        {
+            break;
+        }
+        if (m->cmdtp == NULL && slot == NULL)
+        {
+            slot = m;
+        }
+    }
+    if (m == &marks[STACKHW_MAX] && (m = slot) != NULL)
+    {
+        m->cmdtp = cmdtp;
+        m->worst = 0;
+    }
+    if (m != NULL && used > m->worst)
+    {
+        m->worst = used;
+    }
+    return used;
+}
+
+MInt
+do_stackstat(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    const StackHw *m;
+
+    if (argc == 2)
+    {
+        if (strcmp(argv[1], "clear") != 0)
+        {
+            return 1;
+        }
+        memset(marks, 0, sizeof(marks));
+        return 0;
+    }
+    for (m = marks; m < &marks[STACKHW_MAX]; ++m)
+    {
+        if (m->cmdtp != NULL)
+        {
+            myprintf(0, "%-10s %4u%s\n", m->cmdtp->name, m->worst,
+                     m->worst >= STACKHW_DEPTH ? " overflow" : "");
+        }
+    }
+    myprintf(0, "painted %u bytes\n", STACKHW_DEPTH);
+    return 0;
+}
+#endif
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,124 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   tagreq.c
+ *  \brief  Tagged requests, for hosts that pipeline commands.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include "mytypes.h"
+#include "formats.h"
+#include "tagreq.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+/** Request being run, 0 if none */
+static unsigned int cur;
+
+/** Its handler will complete it */
+static unsigned char deferred;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+int
+tagreq_begin(char **line)
+{
+    char *s;
+    unsigned long tag;
+
+    for (s = *line, tag = 0; (unsigned char)(*s - '0') < 10; ++s)
+    {
+        if ((tag = tag * 10 + (*s - '0')) > TAGREQ_MAX)
+        {
+            break;
+        }
+    }
+    if (tag == 0 || tag > TAGREQ_MAX || (*s != ' ' && *s != '\t'))
+    {
+        myprintf(0, "!0 -1\n");
+        return 1;
+    }
+    *line = s;
+    cur = (unsigned int)tag;
+    deferred = 0;
+    myprintf(0, "@%u\n", cur);
+    return 0;
+}
+
+void
+tagreq_end(int rc)
+{
+    if (!deferred)
+    {
+        tagreq_done(cur, rc);
+    }
+    cur = 0;
+}
+
+unsigned int
+tagreq_defer(void)
+{
+    deferred = cur != 0;
+    return cur;
+}
+
+int
+tagreq_resume(unsigned int tag)
+{
+    if (cur != 0)
+    {
+        return 1;
+    }
+    myprintf(0, "@%u\n", tag);
+    return 0;
+}
+
+void
+tagreq_done(unsigned int tag, int rc)
+{
+    myprintf(0, "!%u %d\n", tag, rc < 0 ? -1 : 0);
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,224 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   tahead.c
+ *  \brief  Type-ahead queue of complete command lines.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Arena layout, indexes grow forever and are masked on access:
+ *
+ *      tail            oldest queued line, its length byte
+ *      head            line in progress, its length byte
+ *      wr              next free byte, wr == head if no line in progress
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include "mytypes.h"
+#include "shellser.h"
+#include "tahead.h"
+#include "deadline.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+#define AT(i)                   arena[(i) & (TAHEAD_SIZE - 1)]
+
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static unsigned char arena[TAHEAD_SIZE];
+static volatile unsigned int tail, head;
+static unsigned int wr;
+
+/** Dropping the rest of current line */
+static unsigned char discard;
+
+static volatile unsigned char busy;
+static TAheadStat stat;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void
+tahead_init(void)
+{
+    tail = head = wr = 0;
+    discard = 0;
+    stat.lines = stat.overflows = stat.toolong = 0;
+}
+
+void
+tahead_busy(int b)
+{
+    busy = (unsigned char)b;
+}
+
+void
+tahead_drain(void)
+{
+    if (busy)
+    {
+        tahead_fill();
+    }
+}
+
+void
+tahead_fill(void)
+{
+    /* A byte takes up to 2, the rest stays queued for flow control */
+    while (TAHEAD_SIZE - (wr - tail) >= 2 && shellser_tstc() == 0)
+    {
+        tahead_put((char)shellser_getc());
+    }
+}
+
+void
+tahead_put(char c)
+{
+    unsigned int need;
+
+    switch (c)
+    {
+        case '\r':
+        case '\n':
+            if (!discard && wr - head > 1)
+            {
+                AT(head) = (unsigned char)(wr - head - 1);
+                head = wr;
+                ++stat.lines;
+            }
+            wr = head;                      /* empty lines are not queued */
+            discard = 0;
+            break;
+        case 0x03:                          /* ^C - discard everything */
+            tail = head = wr;
+            discard = 0;
+#if DEADLINE
+            deadline_cancel(CANCEL_CTRLC);  /* and abort the handler */
+#endif
+            break;
+        case 0x15:                          /* ^U - erase line */
+            wr = head;
+            discard = 0;
+            break;
+        case 0x08:                          /* backspace */
+        case 0x7F:
+            if (!discard && wr - head > 1)
+            {
+                --wr;
+            }
+            break;
+        default:
+            if (discard)
+            {
+                break;
+            }
+            need = wr == head ? 2 : 1;      /* length byte first */
+            if (wr - head - 1 == TAHEAD_LINE)
+            {
+                ++stat.toolong;
+                discard = 1;
+            }
+            else if (wr + need - tail > TAHEAD_SIZE)
+            {
+                ++stat.overflows;
+                discard = 1;
+            }
+            else
+            {
+                wr += need;
+                AT(wr - 1) = (unsigned char)c;
+            }
+            break;
+    }
+}
+
+int
+tahead_pending(void)
+{
+    return wr != tail;
+}
+
+int
+tahead_get(char *line)
+{
+    unsigned int i, n;
+
+    if (tail == head)
+    {
+        return -1;
+    }
+    n = AT(tail);
+    for (i = 0; i < n; ++i)
+    {
+        line[i] = (char)AT(tail + 1 + i);
+    }
+    line[n] = '\0';
+    tail += n + 1;
+    return (int)n;
+}
+
+int
+tahead_partial(char *line)
+{
+    unsigned int i, n;
+
+    if (wr == head)
+    {
+        return 0;
+    }
+    n = wr - head - 1;
+    for (i = 0; i < n; ++i)
+    {
+        line[i] = (char)AT(head + 1 + i);
+    }
+    wr = head;
+    discard = 0;
+    return (int)n;
+}
+
+void
+tahead_stat(TAheadStat *st)
+{
+    *st = stat;
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,380 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   vchan.c
+ *  \brief  Virtual channels multiplexed over the shell serial link.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Ring indexes grow forever and are masked on access. Frames are never 
+ *  longer than 254 bytes before encoding, so COBS needs a single code 
+ *  byte and the encoded frame is one byte longer.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "vchan.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+#define AT(r, i)                (r)[(i) & (VCHAN_BUF - 1)]
+
+/* ------------------------------- Constants ------------------------------- */
+/** Largest frame, before encoding */
+#define FRAME_MAX               (1 + VCHAN_MTU)
+
+/** Grant freed room once it reaches this */
+#define GRANT_MIN               (VCHAN_BUF / 4)
+
+/* ---------------------------- Local data types --------------------------- */
+typedef struct Chan Chan;
+struct Chan
+{
+    unsigned char tx[VCHAN_BUF];
+    unsigned char rx[VCHAN_BUF];
+    unsigned int txh, txt;
+    unsigned int rxh, rxt;
+    unsigned int credit;            /* bytes the peer can still take */
+    unsigned int freed;             /* bytes read, not granted yet */
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static Chan chans[VCHAN_NUM];
+static VChanTx txfn;
+static VChanFilter filters[VCHAN_NUM];
+
+/** Frame being received, still encoded */
+static unsigned char rxf[FRAME_MAX + 1];
+static unsigned int rxn;
+static unsigned char rxbad;
+
+static VChanStat stat;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+reset(void)
+{
+    Chan *c;
+
+    memset(chans, 0, sizeof(chans));
+    for (c = chans; c < &chans[VCHAN_NUM]; ++c)
+    {
+        c->credit = VCHAN_BUF;
+    }
+    rxn = 0;
+    rxbad = 0;
+}
+
+static void
+send_frame(const unsigned char *raw, unsigned int n)
+{
+    unsigned char out[FRAME_MAX + 2];
+    unsigned int i, o, code_at;
+    unsigned char code;
+
+    for (i = 0, o = 1, code_at = 0, code = 1; i < n; ++i)
+    {
+        if (raw[i] == 0)
+        {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        }
+        else
+        {
+            out[o++] = raw[i];
+            ++code;
+        }
+    }
+    out[code_at] = code;
+    out[o++] = 0;
+    ++stat.txframes;
+    txfn(out, o);
+}
+
+static int
+send_data(unsigned int ch)
+{
+    unsigned char raw[FRAME_MAX];
+    Chan *c;
+    unsigned int n, i;
+
+    c = &chans[ch];
+    n = c->txh - c->txt;
+    if (n > c->credit)
+    {
+        n = c->credit;
+    }
+    if (n > VCHAN_MTU)
+    {
+        n = VCHAN_MTU;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+    raw[0] = (unsigned char)(ch << 4 | VCHAN_DATA);
+    for (i = 1; i <= n; ++i)
+    {
+        raw[i] = AT(c->tx, c->txt++);
+    }
+    c->credit -= n;
+    send_frame(raw, n + 1);
+    return 1;
+}
+
+/**
+ *  \brief
+ *  Decode a COBS frame in place.
+ *
+ *  \return
+ *  Decoded length or -1 if it is malformed.
+ */
+static int
+decode(unsigned char *buf, unsigned int n)
+{
+    unsigned int i, o, code, k;
+
+    for (i = 0, o = 0; i < n; )
+    {
+        code = buf[i++];
+        if (i + code - 1 > n)
+        {
+            return -1;
+        }
+        for (k = 1; k < code; ++k)
+        {
+            buf[o++] = buf[i++];
+        }
+        if (code != 0xFF && i < n)
+        {
+            buf[o++] = 0;
+        }
+    }
+    return o;
+}
+
+static void
+dispatch(const unsigned char *p, unsigned int n)
+{
+    Chan *c;
+    unsigned int ch, i;
+
+    ch = p[0] >> 4;
+    if ((p[0] & 0x0F) == VCHAN_SYNC)
+    {
+        reset();
+        ++stat.rxframes;
+        return;
+    }
+    if (ch >= VCHAN_NUM)
+    {
+        ++stat.bad;
+        return;
+    }
+    c = &chans[ch];
+    switch (p[0] & 0x0F)
+    {
+        case VCHAN_DATA:
+            for (i = 1; i < n; ++i)
+            {
+                if (filters[ch] != NULL && filters[ch](p[i]))
+                {
+                    ++c->freed;             /* taken, never read */
+                    continue;
+                }
+                if (c->rxh - c->rxt == VCHAN_BUF)
+                {
+                    stat.overruns += n - i;
+                    break;
+                }
+                AT(c->rx, c->rxh++) = p[i];
+            }
+            break;
+        case VCHAN_CREDIT:
+            if (n != 3)
+            {
+                ++stat.bad;
+                return;
+            }
+            c->credit += p[1] | (p[2] << 8);
+            if (c->credit > VCHAN_BUF)
+            {
+                c->credit = VCHAN_BUF;
+            }
+            break;
+        default:
+            ++stat.bad;
+            return;
+    }
+    ++stat.rxframes;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+vchan_init(VChanTx tx)
+{
+    txfn = tx;
+    reset();
+}
+
+void
+vchan_sync(void)
+{
+    unsigned char raw;
+
+    reset();
+    raw = VCHAN_SYNC;
+    send_frame(&raw, 1);
+}
+
+void
+vchan_rx(unsigned char c)
+{
+    int n;
+
+    if (c != 0)
+    {
+        if (rxn < sizeof(rxf))
+        {
+            rxf[rxn++] = c;
+        }
+        else
+        {
+            rxbad = 1;
+        }
+        return;
+    }
+    if (rxn == 0)                           /* idle terminator */
+    {
+        return;
+    }
+    if (rxbad || (n = decode(rxf, rxn)) <= 0)
+    {
+        ++stat.bad;
+    }
+    else
+    {
+        dispatch(rxf, n);
+    }
+    rxn = 0;
+    rxbad = 0;
+}
+
+void
+vchan_poll(void)
+{
+    unsigned char raw[3];
+    unsigned int ch;
+    Chan *c;
+
+    for (ch = 0, c = chans; ch < VCHAN_NUM; ++ch, ++c)
+    {
+        if (c->freed != 0 && (c->freed >= GRANT_MIN || c->rxh == c->rxt))
+        {
+            raw[0] = (unsigned char)(ch << 4 | VCHAN_CREDIT);
+            raw[1] = (unsigned char)c->freed;
+            raw[2] = (unsigned char)(c->freed >> 8);
+            c->freed = 0;
+            send_frame(raw, 3);
+        }
+    }
+
+    while (send_data(VCHAN_SHELL))
+    {
+    }
+    for (ch = VCHAN_SHELL + 1; ch < VCHAN_NUM; ++ch)
+    {
+        send_data(ch);
+    }
+}
+
+unsigned int
+vchan_write(unsigned int ch, const void *data, unsigned int len)
+{
+    const unsigned char *s;
+    Chan *c;
+    unsigned int n;
+
+    c = &chans[ch];
+    for (s = data, n = 0; n < len && c->txh - c->txt < VCHAN_BUF; ++n)
+    {
+        AT(c->tx, c->txh++) = *s++;
+    }
+    return n;
+}
+
+unsigned int
+vchan_read(unsigned int ch, void *data, unsigned int len)
+{
+    unsigned char *d;
+    Chan *c;
+    unsigned int n;
+
+    c = &chans[ch];
+    for (d = data, n = 0; n < len && c->rxt != c->rxh; ++n)
+    {
+        *d++ = AT(c->rx, c->rxt++);
+    }
+    c->freed += n;
+    return n;
+}
+
+unsigned int
+vchan_avail(unsigned int ch)
+{
+    return chans[ch].rxh - chans[ch].rxt;
+}
+
+void
+vchan_filter(unsigned int ch, VChanFilter fn)
+{
+    filters[ch] = fn;
+}
+
+void
+vchan_stat(VChanStat *st)
+{
+    *st = stat;
+}
+
+/* ------------------------------ End of file ------------------------------ */
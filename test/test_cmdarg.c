@@ -0,0 +1,165 @@
+/**
+ *  \file   test_cmdarg.c
+ *  \brief  Unit test for typed command arguments.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <limits.h>
+#include <stdio.h>
+#include "unity.h"
+#include "cmdarg.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static const char *const onoff[] = {"off", "on", NULL};
+
+static const CMD_ARG args[] =
+{
+    MK_ARG_HEX("port"),
+    MK_ARG_RANGE("value", -10, 255),
+    MK_ARG_ENUM("mode", onoff),
+    MK_ARG_STR("label")
+};
+
+static const CMD_EXT ext = {args, 4, 2, NULL};
+static CMD_VAL vals[MAXARGS + 1];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_Decimal(void)
+{
+    long v;
+    char buf[32];
+
+    TEST_ASSERT_EQUAL(0, cmdarg_dec("0", &v));
+    TEST_ASSERT_EQUAL(0, v);
+    TEST_ASSERT_EQUAL(0, cmdarg_dec("7", &v));
+    TEST_ASSERT_EQUAL(7, v);
+    TEST_ASSERT_EQUAL(0, cmdarg_dec("1234", &v));
+    TEST_ASSERT_EQUAL(1234, v);
+    TEST_ASSERT_EQUAL(0, cmdarg_dec("123456789", &v));
+    TEST_ASSERT_EQUAL(123456789, v);
+    TEST_ASSERT_EQUAL(0, cmdarg_dec("-00042", &v));
+    TEST_ASSERT_EQUAL(-42, v);
+
+    sprintf(buf, "%ld", LONG_MAX);
+    TEST_ASSERT_EQUAL(0, cmdarg_dec(buf, &v));
+    TEST_ASSERT_EQUAL(LONG_MAX, v);
+    sprintf(buf, "%ld", LONG_MIN);
+    TEST_ASSERT_EQUAL(0, cmdarg_dec(buf, &v));
+    TEST_ASSERT_EQUAL(LONG_MIN, v);
+}
+
+void
+test_BadDecimal(void)
+{
+    long v;
+    char buf[32];
+
+    TEST_ASSERT_EQUAL(1, cmdarg_dec("", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_dec("-", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_dec("12a4", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_dec("1234:", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_dec("12/4", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_dec("0x10", &v));
+    sprintf(buf, "%lu0", ULONG_MAX);
+    TEST_ASSERT_EQUAL(1, cmdarg_dec(buf, &v));
+    sprintf(buf, "%lu", (unsigned long)LONG_MAX + 1);
+    TEST_ASSERT_EQUAL(1, cmdarg_dec(buf, &v));
+}
+
+void
+test_Hexadecimal(void)
+{
+    unsigned long v;
+
+    TEST_ASSERT_EQUAL(0, cmdarg_hex("f", &v));
+    TEST_ASSERT_EQUAL(0xF, v);
+    TEST_ASSERT_EQUAL(0, cmdarg_hex("0x1A2b", &v));
+    TEST_ASSERT_EQUAL(0x1A2B, v);
+    TEST_ASSERT_EQUAL(0, cmdarg_hex("DEADbeef", &v));
+    TEST_ASSERT_EQUAL(0xDEADBEEFUL, v);
+    TEST_ASSERT_EQUAL(0, cmdarg_hex("0X09afAF9", &v));
+    TEST_ASSERT_EQUAL(0x09AFAF9UL, v);
+}
+
+void
+test_BadHexadecimal(void)
+{
+    unsigned long v;
+
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("0x", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("12g4", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("@ABC", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("`abc", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("12:4", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("1\xb1" "34", &v));
+    TEST_ASSERT_EQUAL(1, cmdarg_hex("123456789abcdef01", &v));
+}
+
+void
+test_ParseSchema(void)
+{
+    char *argv[] = {"outp", "0x3f8", "-10", "on", "uart", NULL};
+
+    TEST_ASSERT_EQUAL(CMDARG_OK, cmdarg_parse(&ext, 5, argv, vals));
+    TEST_ASSERT_EQUAL_STRING("outp", vals[0].s);
+    TEST_ASSERT_EQUAL(0x3F8, vals[1].u);
+    TEST_ASSERT_EQUAL(-10, vals[2].i);
+    TEST_ASSERT_EQUAL(1, vals[3].i);
+    TEST_ASSERT_EQUAL_STRING("uart", vals[4].s);
+}
+
+void
+test_ParseOptionalArgs(void)
+{
+    char *argv[] = {"outp", "10", "255", NULL};
+
+    TEST_ASSERT_EQUAL(CMDARG_OK, cmdarg_parse(&ext, 3, argv, vals));
+    TEST_ASSERT_EQUAL(0x10, vals[1].u);
+    TEST_ASSERT_EQUAL(255, vals[2].i);
+}
+
+void
+test_ParseReportsBadArgument(void)
+{
+    char *range[] = {"outp", "10", "256", NULL};
+    char *key[] = {"outp", "10", "1", "of", NULL};
+
+    TEST_ASSERT_EQUAL(2, cmdarg_parse(&ext, 3, range, vals));
+    TEST_ASSERT_EQUAL(3, cmdarg_parse(&ext, 4, key, vals));
+}
+
+void
+test_ParseReportsArgumentCount(void)
+{
+    char *argv[] = {"outp", "10", "1", "on", "uart", "x", NULL};
+
+    TEST_ASSERT_EQUAL(CMDARG_COUNT, cmdarg_parse(&ext, 2, argv, vals));
+    TEST_ASSERT_EQUAL(CMDARG_COUNT, cmdarg_parse(&ext, 6, argv, vals));
+}
+
+/* ------------------------------ End of file ------------------------------ */
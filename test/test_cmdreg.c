@@ -0,0 +1,193 @@
+/**
+ *  \file   test_cmdreg.c
+ *  \brief  Unit test for runtime registry of commands.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The stress test poisons and frees every entry as soon as it is 
+ *  removed, so a reader using a reclaimed entry sees a bad name or 
+ *  handler.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "unity.h"
+#include "cmdreg.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+#define NUM_READERS             4
+#define NUM_ROUNDS              1000
+#define NUM_NAMES               4
+
+/* ---------------------------- Local data types --------------------------- */
+typedef struct Entry Entry;
+struct Entry
+{
+    CMD_TABLE cmd;
+    char name[8];
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static const char *const names[NUM_NAMES] = {"plga", "plgb", "plgc", "plgd"};
+static volatile int stop;
+static volatile unsigned long lookups, hits, errors;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static MInt
+do_plugin(const CMD_TABLE *cmdtp, MInt argc, char *argv[])
+{
+    return 0;
+}
+
+static Entry *
+new_entry(const char *name)
+{
+    Entry *e;
+
+    e = malloc(sizeof(Entry));
+    strcpy(e->name, name);
+    e->cmd.name = e->name;
+    e->cmd.lmin = 4;
+    e->cmd.maxargs = 1;
+    e->cmd.cmd = do_plugin;
+    e->cmd.usage = NULL;
+    e->cmd.ext = NULL;
+    return e;
+}
+
+static void
+free_entry(Entry *e)
+{
+    memset(e, 0xA5, sizeof(Entry));
+    free(e);
+}
+
+static void *
+reader(void *arg)
+{
+    const CMD_TABLE *cmdtp;
+    unsigned int tok, i;
+
+    for (i = 0; !stop; ++i)
+    {
+        tok = cmdreg_read_lock();
+        if ((cmdtp = cmdreg_find(names[i % NUM_NAMES])) != NULL)
+        {
+            if (strcmp(cmdtp->name, names[i % NUM_NAMES]) != 0 ||
+                cmdtp->cmd != do_plugin)
+            {
+                __sync_fetch_and_add(&errors, 1);
+            }
+            __sync_fetch_and_add(&hits, 1);
+        }
+        cmdreg_read_unlock(tok);
+        __sync_fetch_and_add(&lookups, 1);
+    }
+    return NULL;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_AddFindRemove(void)
+{
+    Entry *a, *b;
+    unsigned int tok;
+
+    a = new_entry("plga");
+    b = new_entry("plgb");
+    TEST_ASSERT_EQUAL(0, cmdreg_add(&a->cmd));
+    TEST_ASSERT_EQUAL(0, cmdreg_add(&b->cmd));
+    TEST_ASSERT_EQUAL(1, cmdreg_add(&a->cmd));
+
+    tok = cmdreg_read_lock();
+    TEST_ASSERT_EQUAL_PTR(&a->cmd, cmdreg_find("plga"));
+    TEST_ASSERT_EQUAL_PTR(&b->cmd, cmdreg_find("plgbxx"));
+    TEST_ASSERT_NULL(cmdreg_find("plg"));
+    TEST_ASSERT_EQUAL_PTR(&b->cmd, cmdreg_at(1));
+    TEST_ASSERT_NULL(cmdreg_at(2));
+    cmdreg_read_unlock(tok);
+
+    TEST_ASSERT_EQUAL(0, cmdreg_remove("plga"));
+    TEST_ASSERT_EQUAL(1, cmdreg_remove("plga"));
+    TEST_ASSERT_NULL(cmdreg_find("plga"));
+    TEST_ASSERT_EQUAL_PTR(&b->cmd, cmdreg_at(0));
+    TEST_ASSERT_EQUAL(0, cmdreg_remove("plgb"));
+    TEST_ASSERT_NULL(cmdreg_at(0));
+    free_entry(a);
+    free_entry(b);
+}
+
+void
+test_RemoveWhileLookingUp(void)
+{
+    pthread_t th[NUM_READERS];
+    Entry *live[NUM_NAMES] = {NULL};
+    unsigned int i, k;
+
+    for (i = 0; i < NUM_READERS; ++i)
+    {
+        pthread_create(&th[i], NULL, reader, NULL);
+    }
+
+    for (i = 0; i < NUM_ROUNDS; ++i)
+    {
+        k = i % NUM_NAMES;
+        if (live[k] == NULL)
+        {
+            live[k] = new_entry(names[k]);
+            TEST_ASSERT_EQUAL(0, cmdreg_add(&live[k]->cmd));
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(0, cmdreg_remove(names[k]));
+            free_entry(live[k]);
+            live[k] = NULL;
+        }
+        sched_yield();                      /* let readers run */
+    }
+
+    stop = 1;
+    for (i = 0; i < NUM_READERS; ++i)
+    {
+        pthread_join(th[i], NULL);
+    }
+    for (k = 0; k < NUM_NAMES; ++k)
+    {
+        if (live[k] != NULL)
+        {
+            cmdreg_remove(names[k]);
+            free_entry(live[k]);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0, errors);
+    TEST_ASSERT_TRUE(lookups > 0);
+    TEST_ASSERT_TRUE(hits > 0);
+    TEST_ASSERT_NULL(cmdreg_at(0));
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,60 @@
+/**
+ *  \file   test_conabort.c
+ *  \brief  Unit test for out-of-band ^C.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include "unity.h"
+#include "conabort.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    (void)conabort_take();
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_PassOtherBytes(void)
+{
+    unsigned int c;
+
+    for (c = 0; c < 256; ++c)
+    {
+        if (c != 0x03)
+        {
+            TEST_ASSERT_EQUAL(0, conabort_rx((unsigned char)c));
+        }
+    }
+    TEST_ASSERT_EQUAL(0, conabort_take());
+}
+
+void
+test_TakeCtrlCOnce(void)
+{
+    TEST_ASSERT_EQUAL(1, conabort_rx(0x03));
+    TEST_ASSERT_EQUAL(1, conabort_rx(0x03));
+    TEST_ASSERT_EQUAL(1, conabort_take());
+    TEST_ASSERT_EQUAL(0, conabort_take());
+}
+
+/* ------------------------------ End of file ------------------------------ */
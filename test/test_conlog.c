@@ -0,0 +1,125 @@
+/**
+ *  \file   test_conlog.c
+ *  \brief  Unit test for asynchronous log ring.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "conlog.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+#define NUM_LAPS                1000
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static char rec[CONLOG_LEN];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    while (conlog_get(rec) >= 0)
+        ;
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_GetRecordsInOrder(void)
+{
+    TEST_ASSERT_FALSE(conlog_pending());
+    TEST_ASSERT_EQUAL(0, conlog_puts("adc ready"));
+    TEST_ASSERT_EQUAL(0, conlog_puts("link up"));
+
+    TEST_ASSERT_TRUE(conlog_pending());
+    TEST_ASSERT_EQUAL(9, conlog_get(rec));
+    TEST_ASSERT_EQUAL_STRING("adc ready", rec);
+    TEST_ASSERT_EQUAL(7, conlog_get(rec));
+    TEST_ASSERT_EQUAL_STRING("link up", rec);
+    TEST_ASSERT_EQUAL(-1, conlog_get(rec));
+    TEST_ASSERT_FALSE(conlog_pending());
+}
+
+void
+test_TruncateLongRecord(void)
+{
+    char text[CONLOG_LEN + 10];
+
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    TEST_ASSERT_EQUAL(0, conlog_puts(text));
+
+    TEST_ASSERT_EQUAL(CONLOG_LEN - 1, conlog_get(rec));
+    TEST_ASSERT_EQUAL_MEMORY(text, rec, CONLOG_LEN - 1);
+}
+
+void
+test_DropWhenFull(void)
+{
+    ConLogStat before, after;
+    int i;
+
+    conlog_stat(&before);
+    for (i = 0; i < CONLOG_SLOTS; ++i)
+    {
+        sprintf(rec, "rec %d", i);
+        TEST_ASSERT_EQUAL(0, conlog_puts(rec));
+    }
+    TEST_ASSERT_EQUAL(1, conlog_puts("lost"));
+    conlog_stat(&after);
+    TEST_ASSERT_EQUAL(before.dropped + 1, after.dropped);
+
+    /* Oldest records are kept, one free slot takes a new one */
+    TEST_ASSERT_EQUAL(5, conlog_get(rec));
+    TEST_ASSERT_EQUAL_STRING("rec 0", rec);
+    TEST_ASSERT_EQUAL(0, conlog_puts("again"));
+    for (i = 1; i < CONLOG_SLOTS; ++i)
+    {
+        conlog_get(rec);
+    }
+    conlog_get(rec);
+    TEST_ASSERT_EQUAL_STRING("again", rec);
+    conlog_stat(&after);
+    TEST_ASSERT_EQUAL(before.records + CONLOG_SLOTS + 1, after.records);
+}
+
+void
+test_ReuseSlotsForManyLaps(void)
+{
+    char text[CONLOG_LEN];
+    int i, j;
+
+    for (i = 0; i < NUM_LAPS; ++i)
+    {
+        for (j = 0; j < 3; ++j)
+        {
+            sprintf(text, "%d.%d", i, j);
+            TEST_ASSERT_EQUAL(0, conlog_puts(text));
+        }
+        for (j = 0; j < 3; ++j)
+        {
+            sprintf(text, "%d.%d", i, j);
+            TEST_ASSERT_TRUE(conlog_get(rec) > 0);
+            TEST_ASSERT_EQUAL_STRING(text, rec);
+        }
+    }
+    TEST_ASSERT_FALSE(conlog_pending());
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,137 @@
+/**
+ *  \file   test_conring.c
+ *  \brief  Unit test for capture of console output while detached.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "unity.h"
+#include "conring.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static char buf[2 * CONRING_SIZE];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static unsigned int
+read_all(void)
+{
+    unsigned long pos;
+    unsigned int n, k;
+
+    for (pos = conring_first(), n = 0; 
+         (k = conring_read(&pos, buf + n, 7)) != 0; n += k)
+        ;
+    return n;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    conring_clear();
+    conring_detach(0);
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_DetachOnPurpose(void)
+{
+    TEST_ASSERT_FALSE(conring_detached());
+    conring_detach(1);
+    TEST_ASSERT_TRUE(conring_detached());
+    conring_detach(0);
+    TEST_ASSERT_FALSE(conring_detached());
+}
+
+void
+test_ReplayInOrder(void)
+{
+    ConRingStat st;
+
+    conring_write("link down\n", 10);
+    conring_write("retry 1\n", 8);
+    TEST_ASSERT_EQUAL(18, read_all());
+    TEST_ASSERT_EQUAL_MEMORY("link down\nretry 1\n", buf, 18);
+    conring_stat(&st);
+    TEST_ASSERT_EQUAL(18, st.captured);
+    TEST_ASSERT_EQUAL(0, st.lost);
+}
+
+void
+test_OverwriteOldest(void)
+{
+    ConRingStat st;
+    unsigned int i;
+    char c;
+
+    for (i = 0; i < CONRING_SIZE + 100; ++i)
+    {
+        c = (char)('a' + i % 26);
+        conring_write(&c, 1);
+    }
+    TEST_ASSERT_EQUAL(CONRING_SIZE, read_all());
+    TEST_ASSERT_EQUAL('a' + 100 % 26, buf[0]);
+    TEST_ASSERT_EQUAL('a' + (CONRING_SIZE + 99) % 26, buf[CONRING_SIZE - 1]);
+    conring_stat(&st);
+    TEST_ASSERT_EQUAL(CONRING_SIZE + 100, st.captured);
+    TEST_ASSERT_EQUAL(100, st.lost);
+}
+
+void
+test_KeepNewestOfLongWrite(void)
+{
+    static char data[CONRING_SIZE + 3];
+    unsigned int i;
+
+    for (i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (char)i;
+    }
+    conring_write("x", 1);
+    conring_write(data, sizeof(data));
+    TEST_ASSERT_EQUAL(CONRING_SIZE, read_all());
+    TEST_ASSERT_EQUAL_MEMORY(data + 3, buf, CONRING_SIZE);
+}
+
+void
+test_SkipOverwrittenPosition(void)
+{
+    unsigned long pos;
+    static char data[CONRING_SIZE];
+
+    memset(data, 'z', sizeof(data));
+    conring_write("old", 3);
+    pos = conring_first();
+    conring_write(data, sizeof(data));
+    TEST_ASSERT_EQUAL(2, conring_read(&pos, buf, 2));
+    TEST_ASSERT_EQUAL_MEMORY("zz", buf, 2);
+}
+
+void
+test_ClearForgetsAll(void)
+{
+    conring_write("abc", 3);
+    conring_clear();
+    TEST_ASSERT_EQUAL(0, read_all());
+    conring_write("d", 1);
+    TEST_ASSERT_EQUAL(1, read_all());
+    TEST_ASSERT_EQUAL('d', buf[0]);
+}
+
+/* ------------------------------ End of file ------------------------------ */
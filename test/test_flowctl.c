@@ -0,0 +1,129 @@
+/**
+ *  \file   test_flowctl.c
+ *  \brief  Unit test for flow control of console input.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include "unity.h"
+#include "flowctl.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static int stops, resumes, ready;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+receive(unsigned int n)
+{
+    while (n-- > 0)
+    {
+        flowctl_rx();
+    }
+}
+
+static void
+take(unsigned int n)
+{
+    while (n-- > 0)
+    {
+        flowctl_take();
+    }
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+conser_flow(int r)
+{
+    ready = r;
+    if (r)
+    {
+        ++resumes;
+    }
+    else
+    {
+        ++stops;
+    }
+}
+
+void 
+setUp(void)
+{
+    flowctl_reset();
+    stops = resumes = 0;
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_ResetTellsReady(void)
+{
+    ready = 0;
+    flowctl_reset();
+    TEST_ASSERT_EQUAL(1, ready);
+}
+
+void
+test_StopAtHighWatermark(void)
+{
+    receive(FLOWCTL_HIGH - 1);
+    TEST_ASSERT_EQUAL(0, stops);
+    receive(1);
+    TEST_ASSERT_EQUAL(1, stops);
+    TEST_ASSERT_EQUAL(0, ready);
+    receive(5);
+    TEST_ASSERT_EQUAL(1, stops);
+}
+
+void
+test_ResumeAtLowWatermark(void)
+{
+    receive(FLOWCTL_HIGH);
+    take(FLOWCTL_HIGH - FLOWCTL_LOW - 1);
+    TEST_ASSERT_EQUAL(0, resumes);
+    take(1);
+    TEST_ASSERT_EQUAL(1, resumes);
+    TEST_ASSERT_EQUAL(1, ready);
+    take(FLOWCTL_LOW);
+    TEST_ASSERT_EQUAL(1, resumes);
+}
+
+void
+test_NoResumeWhileRunning(void)
+{
+    receive(FLOWCTL_LOW + 1);
+    take(FLOWCTL_LOW + 1);
+    TEST_ASSERT_EQUAL(0, resumes);
+    TEST_ASSERT_EQUAL(0, stops);
+}
+
+void
+test_Stat(void)
+{
+    FlowCtlStat st, before;
+
+    flowctl_stat(&before);
+    receive(FLOWCTL_HIGH + 3);
+    take(2);
+    take(FLOWCTL_HIGH * 2);                 /* more than counted */
+    flowctl_stat(&st);
+    TEST_ASSERT_EQUAL(before.xoffs + 1, st.xoffs);
+    TEST_ASSERT_EQUAL(before.late + 3, st.late);
+    TEST_ASSERT_EQUAL(0, st.pending);
+    TEST_ASSERT_TRUE(st.peak >= FLOWCTL_HIGH + 3);
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,134 @@
+/**
+ *  \file   test_hexfmt.c
+ *  \brief  Unit test for hex formatting of memory rows.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "unity.h"
+#include "hexfmt.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static const unsigned char data[HEXFMT_ROW] =
+{
+    'H', 'e', 'l', 'l', 'o', '\n', 0x00, 0x7F,
+    0x80, 0xFF, 0x20, 0x7E, 0x12, 0x34, 0x56, 0x78
+};
+
+static char row[HEXFMT_ROWLEN];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static int
+little_endian(void)
+{
+    uint16_t w = 1;
+
+    return *(unsigned char *)&w == 1;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    memset(row, '#', sizeof(row));
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_FormatAddress(void)
+{
+    char addr[HEXFMT_ROWLEN];
+
+    hexfmt_row(row, 0x2000ABCDUL, data, HEXFMT_ROW, 1);
+    sprintf(addr, "%0*lx:", (int)HEXFMT_ADDR, 0x2000ABCDUL);
+    TEST_ASSERT_EQUAL_MEMORY(addr, row, HEXFMT_ADDR + 1);
+}
+
+void
+test_FormatBytes(void)
+{
+    unsigned int len;
+
+    len = hexfmt_row(row, 0, data, HEXFMT_ROW, 1);
+    TEST_ASSERT_EQUAL(HEXFMT_ROWLEN - 1, len);
+    TEST_ASSERT_EQUAL(len, strlen(row));
+    TEST_ASSERT_EQUAL_STRING(
+        " 48 65 6c 6c 6f 0a 00 7f 80 ff 20 7e 12 34 56 78"
+        "  Hello..... ~.4Vx\n",
+        row + HEXFMT_ADDR + 1);
+}
+
+void
+test_FormatWords(void)
+{
+    hexfmt_row(row, 0, data + 12, 4, 4);
+    TEST_ASSERT_EQUAL_STRING(little_endian() ?
+        " 78563412                             .4Vx\n" :
+        " 12345678                             .4Vx\n",
+        row + HEXFMT_ADDR + 1);
+
+    hexfmt_row(row, 0, data + 12, 4, 2);
+    TEST_ASSERT_EQUAL_STRING(little_endian() ?
+        " 3412 7856                                .4Vx\n" :
+        " 1234 5678                                .4Vx\n",
+        row + HEXFMT_ADDR + 1);
+}
+
+void
+test_LineUpShortRow(void)
+{
+    char full[HEXFMT_ROWLEN];
+    unsigned int width;
+
+    for (width = 1; width <= 4; width <<= 1)
+    {
+        hexfmt_row(full, 0, data, HEXFMT_ROW, width);
+        hexfmt_row(row, 0, data, 4, width);
+        TEST_ASSERT_EQUAL(strchr(full, 'H') - full, strchr(row, 'H') - row);
+    }
+}
+
+void
+test_FormatAllBytes(void)
+{
+    unsigned char all[HEXFMT_ROW];
+    char expect[3 * HEXFMT_ROW + 1];
+    unsigned int b, i;
+
+    for (b = 0; b < 256; b += HEXFMT_ROW)
+    {
+        for (i = 0; i < HEXFMT_ROW; ++i)
+        {
+            all[i] = (unsigned char)(b + i);
+            sprintf(expect + 3 * i, " %02x", b + i);
+        }
+        hexfmt_row(row, 0, all, HEXFMT_ROW, 1);
+        TEST_ASSERT_EQUAL_MEMORY(expect, row + HEXFMT_ADDR + 1,
+                                 3 * HEXFMT_ROW);
+        for (i = 0; i < HEXFMT_ROW; ++i)
+        {
+            TEST_ASSERT_EQUAL(b + i >= 0x20 && b + i < 0x7F ? b + i : '.',
+                              row[HEXFMT_ROWLEN - 2 - HEXFMT_ROW + i]);
+        }
+    }
+}
+
+/* ------------------------------ End of file ------------------------------ */
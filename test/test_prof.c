@@ -0,0 +1,144 @@
+/**
+ *  \file   test_prof.c
+ *  \brief  Unit test for sampling profiler.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include "unity.h"
+#include "prof.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+#define LO                      0x1000UL
+#define HI                      (LO + PROF_BUCKETS * 4)
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static const ProfSym syms[] =
+{
+    {LO, "main"},
+    {LO + 0x40, "parse"},
+    {LO + 0x80, "idle"}
+};
+
+static ProfHot hot[PROF_TOP];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+sample(unsigned long pc, unsigned int n)
+{
+    while (n-- != 0)
+    {
+        prof_sample(pc);
+    }
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    prof_symbols(NULL, 0);
+    TEST_ASSERT_EQUAL(0, prof_start(LO, HI));
+}
+
+void 
+tearDown(void)
+{
+    prof_stop();
+}
+
+void
+test_RejectEmptyRange(void)
+{
+    TEST_ASSERT_EQUAL(1, prof_start(HI, LO));
+    TEST_ASSERT_EQUAL(1, prof_start(LO, LO));
+}
+
+void
+test_CountOutOfRange(void)
+{
+    ProfStat st;
+
+    sample(LO - 1, 2);
+    sample(HI, 3);
+    sample(LO, 1);
+    prof_stat(&st);
+    TEST_ASSERT_EQUAL(6, st.samples);
+    TEST_ASSERT_EQUAL(5, st.outside);
+    TEST_ASSERT_EQUAL(1, prof_top(hot, PROF_TOP));
+}
+
+void
+test_RankRanges(void)
+{
+    sample(LO + 0x10, 3);
+    sample(LO + 0x11, 2);   /* same 4 bytes range */
+    sample(HI - 1, 7);
+    sample(LO + 0x20, 1);
+
+    TEST_ASSERT_EQUAL(3, prof_top(hot, PROF_TOP));
+    TEST_ASSERT_EQUAL(HI - 4, hot[0].addr);
+    TEST_ASSERT_EQUAL(7, hot[0].count);
+    TEST_ASSERT_EQUAL(LO + 0x10, hot[1].addr);
+    TEST_ASSERT_EQUAL(5, hot[1].count);
+    TEST_ASSERT_EQUAL(LO + 0x20, hot[2].addr);
+    TEST_ASSERT_NULL(hot[2].name);
+
+    TEST_ASSERT_EQUAL(2, prof_top(hot, 2));
+    TEST_ASSERT_EQUAL(7, hot[0].count);
+    TEST_ASSERT_EQUAL(5, hot[1].count);
+}
+
+void
+test_MergeRangesByFunction(void)
+{
+    prof_symbols(syms, sizeof(syms) / sizeof(syms[0]));
+    sample(LO + 0x44, 2);
+    sample(LO + 0x7C, 2);
+    sample(LO + 0x10, 3);
+    sample(HI - 1, 1);
+
+    TEST_ASSERT_EQUAL(3, prof_top(hot, PROF_TOP));
+    TEST_ASSERT_EQUAL_STRING("parse", hot[0].name);
+    TEST_ASSERT_EQUAL(LO + 0x40, hot[0].addr);
+    TEST_ASSERT_EQUAL(4, hot[0].count);
+    TEST_ASSERT_EQUAL_STRING("main", hot[1].name);
+    TEST_ASSERT_EQUAL(3, hot[1].count);
+    TEST_ASSERT_EQUAL_STRING("idle", hot[2].name);
+}
+
+void
+test_WidenRangesForLargeRegion(void)
+{
+    TEST_ASSERT_EQUAL(0, prof_start(0, PROF_BUCKETS * 64UL));
+    sample(0, 1);
+    sample(63, 1);                      /* same 64 bytes range */
+    sample(PROF_BUCKETS * 64UL - 1, 1); /* last range */
+    TEST_ASSERT_EQUAL(2, prof_top(hot, PROF_TOP));
+    TEST_ASSERT_EQUAL(0, hot[0].addr);
+    TEST_ASSERT_EQUAL(2, hot[0].count);
+    TEST_ASSERT_EQUAL(PROF_BUCKETS * 64UL - 64, hot[1].addr);
+}
+
+void
+test_IgnoreWhileStopped(void)
+{
+    ProfStat st;
+
+    prof_stop();
+    sample(LO, 4);
+    prof_stat(&st);
+    TEST_ASSERT_EQUAL(0, st.samples);
+    TEST_ASSERT_FALSE(st.running);
+}
+
+/* ------------------------------ End of file ------------------------------ */
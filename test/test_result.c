@@ -0,0 +1,155 @@
+/**
+ *  \file   test_result.c
+ *  \brief  Unit test for structured results of commands.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "unity.h"
+#include "result.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static char out[256];
+static unsigned int nout;
+
+static const unsigned char data[] = {0x01, 0xA0, 0xFF, 0x20};
+
+/* ----------------------- Local function prototypes ----------------------- */
+void conser_putc(const char c);
+void conser_puts(const char *s);
+
+/* ---------------------------- Local functions ---------------------------- */
+static void
+port_data(void)
+{
+    result_map(2);
+    result_key("port");
+    result_uint(3);
+    result_key("data");
+    result_bytes(data, sizeof(data));
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+conser_putc(const char c)
+{
+    out[nout++] = c;
+}
+
+void
+conser_puts(const char *s)
+{
+    while (*s != '\0')
+    {
+        conser_putc(*s++);
+    }
+}
+
+void 
+setUp(void)
+{
+    memset(out, 0, sizeof(out));
+    nout = 0;
+    result_reset();
+    result_set_mode(RESULT_TEXT);
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_TextMap(void)
+{
+    port_data();
+    TEST_ASSERT_EQUAL_STRING("port: 3\ndata: 01 a0 ff 20\n", out);
+}
+
+void
+test_CborMap(void)
+{
+    static const unsigned char cbor[] =
+    {
+        0xA2, 0x64, 'p', 'o', 'r', 't', 0x03,
+        0x64, 'd', 'a', 't', 'a', 0x44, 0x01, 0xA0, 0xFF, 0x20
+    };
+
+    result_set_mode(RESULT_CBOR);
+    port_data();
+    TEST_ASSERT_EQUAL(sizeof(cbor), nout);
+    TEST_ASSERT_EQUAL_MEMORY(cbor, out, sizeof(cbor));
+}
+
+void
+test_CborIntegers(void)
+{
+    static const unsigned char cbor[] =
+    {
+        0x00, 0x17, 0x18, 0x18, 0x18, 0xFF, 0x19, 0x01, 0x00,
+        0x1A, 0x00, 0x01, 0x00, 0x00, 0x20, 0x39, 0x01, 0xF3
+    };
+
+    result_set_mode(RESULT_CBOR);
+    result_uint(0);
+    result_uint(23);
+    result_uint(24);
+    result_uint(255);
+    result_uint(256);
+    result_uint(65536);
+    result_int(-1);
+    result_int(-500);
+    TEST_ASSERT_EQUAL(sizeof(cbor), nout);
+    TEST_ASSERT_EQUAL_MEMORY(cbor, out, sizeof(cbor));
+}
+
+void
+test_TextNested(void)
+{
+    result_map(2);
+    result_key("ports");
+    result_array(2);
+    result_uint(1);
+    result_int(-2);
+    result_key("up");
+    result_bool(1);
+    TEST_ASSERT_EQUAL_STRING("ports:\n  1\n  -2\nup: true\n", out);
+}
+
+void
+test_Indefinite(void)
+{
+    static const unsigned char cbor[] = {0x9F, 0x01, 0x61, 'x', 0xFF, 0x02};
+
+    result_set_mode(RESULT_CBOR);
+    result_array(RESULT_INDEF);
+    result_uint(1);
+    result_str("x");
+    result_end();
+    result_uint(2);
+    TEST_ASSERT_EQUAL(sizeof(cbor), nout);
+    TEST_ASSERT_EQUAL_MEMORY(cbor, out, sizeof(cbor));
+}
+
+void
+test_ResetForgetsOpenMap(void)
+{
+    result_map(2);
+    result_key("a");
+    result_reset();
+    result_uint(5);
+    TEST_ASSERT_EQUAL_STRING("a:5\n", out);
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,409 @@
+/**
+ *  \file   test_script.c
+ *  \brief  Unit test for the on-device script engine.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The shell is replaced by a command table of its own, looked up by
+ *  exact name, and the console by a buffer.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "unity.h"
+#include "command.h"
+#include "cmdarg.h"
+#include "deadline.h"
+#include "script.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+volatile unsigned char deadline_token;
+
+/* ---------------------------- Local variables ---------------------------- */
+static char out[512];
+static unsigned int nout;
+static int nfail;
+
+/* ----------------------- Local function prototypes ----------------------- */
+void conser_putc(const char c);
+void conser_puts(const char *s);
+int myprintf(int port, const char *fmt, ...);
+static MInt do_echo(const CMD_TABLE *p, MInt argc, char *argv[]);
+static MInt do_getb(const CMD_TABLE *p, MInt argc, char *argv[]);
+static MInt do_fail(const CMD_TABLE *p, MInt argc, char *argv[]);
+static MInt do_cancel(const CMD_TABLE *p, MInt argc, char *argv[]);
+
+/* ---------------------------- Local functions ---------------------------- */
+static const CMD_TABLE net_tbl[] =
+{
+    MK_CMD_TBL_ENTRY("stat", 4, 2, do_echo, NULL, NULL),
+    MK_CMD_TBL_ENTRY(NULL, 0, 0, NULL, NULL, NULL)
+};
+
+static const CMD_EXT net_ext = MK_CMD_GROUP_EXT(net_tbl);
+
+static const CMD_TABLE cmds[] =
+{
+    MK_CMD_TBL_ENTRY("echo", 4, 4, do_echo, NULL, NULL),
+    MK_CMD_TBL_ENTRY("getb", 4, 1, do_getb, NULL, NULL),
+    MK_CMD_TBL_ENTRY("fail", 4, 1, do_fail, NULL, NULL),
+    MK_CMD_TBL_ENTRY("cancel", 6, 1, do_cancel, NULL, NULL),
+    MK_CMD_TBL_ENTRY("run", 3, 2, do_run, NULL, NULL),
+    MK_CMD_TBL_GROUP("net", 3, NULL, &net_ext),
+    MK_CMD_TBL_ENTRY(NULL, 0, 0, NULL, NULL, NULL)
+};
+
+static MInt
+do_echo(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    MInt i;
+
+    for (i = 1; i < argc; ++i)
+    {
+        conser_puts(argv[i]);
+        conser_putc(i + 1 < argc ? ' ' : '\n');
+    }
+    return 0;
+}
+
+static MInt
+do_getb(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    myprintf(0, "bytes 0x%x\n", 42);
+    return 0;
+}
+
+static MInt
+do_fail(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    ++nfail;
+    return 1;
+}
+
+static MInt
+do_cancel(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    deadline_token = CANCEL_CTRLC;
+    return 0;
+}
+
+/**
+ *  \brief
+ *  Define a script from its lines, the "." closing it is added here.
+ */
+static void
+define(const char *name, const char *const *lines)
+{
+    char buf[64];
+
+    TEST_ASSERT_EQUAL(0, script_define(name));
+    for (; *lines != NULL; ++lines)
+    {
+        strcpy(buf, *lines);
+        script_line(buf);
+    }
+    strcpy(buf, ".");
+    script_line(buf);
+    TEST_ASSERT_FALSE(script_defining());
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+conser_putc(const char c)
+{
+    if (!script_capture(&c, 1) && nout < sizeof(out) - 1)
+    {
+        out[nout++] = c;
+    }
+}
+
+void
+conser_puts(const char *s)
+{
+    while (*s != '\0')
+    {
+        conser_putc(*s++);
+    }
+}
+
+int
+myprintf(int port, const char *fmt, ...)
+{
+    char buf[128];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    conser_puts(buf);
+    return 0;
+}
+
+const CMD_TABLE *
+find_cmd_in(const CMD_TABLE *tbl, const char *cmd)
+{
+    for (; tbl->name != NULL; ++tbl)
+    {
+        if (strcmp(tbl->name, cmd) == 0)
+        {
+            return tbl;
+        }
+    }
+    return NULL;
+}
+
+const CMD_TABLE *
+find_cmd(const char *cmd)
+{
+    return find_cmd_in(cmds, cmd);
+}
+
+int
+simshell_exec(const CMD_TABLE *cmdtp, int argc, char *argv[])
+{
+    const CMD_TABLE *sub;
+
+    while (cmd_is_group(cmdtp) && argc > 1 &&
+           (sub = find_cmd_in(cmdtp->ext->sub, argv[1])) != NULL)
+    {
+        cmdtp = sub;
+        --argc;
+        ++argv;
+    }
+    return cmdtp->cmd(cmdtp, argc, argv) == 0 ? 0 : -1;
+}
+
+void
+setUp(void)
+{
+    memset(out, 0, sizeof(out));
+    nout = 0;
+    nfail = 0;
+    deadline_token = CANCEL_NONE;
+}
+
+void
+tearDown(void)
+{
+    script_delete("t");
+    script_delete("u");
+}
+
+void
+test_RunCommandsInOrder(void)
+{
+    static const char *const lines[] =
+    {
+        "# comment", "echo a", "", "net stat b", "echo c d", NULL
+    };
+
+    define("t", lines);
+    TEST_ASSERT_EQUAL(0, script_run("t"));
+    TEST_ASSERT_EQUAL_STRING("a\nb\nc d\n", out);
+}
+
+void
+test_LoopsAndConditions(void)
+{
+    static const char *const lines[] =
+    {
+        "loop 2",
+        "  set n 3",
+        "  while n > 0",
+        "    if n == 2",
+        "      echo two",
+        "    else",
+        "      echo $n",
+        "    end",
+        "    set n n - 1",
+        "  end",
+        "end",
+        "loop 0",
+        "  echo never",
+        "end",
+        NULL
+    };
+
+    define("t", lines);
+    TEST_ASSERT_EQUAL(0, script_run("t"));
+    TEST_ASSERT_EQUAL_STRING("3\ntwo\n1\n3\ntwo\n1\n", out);
+}
+
+void
+test_LetTakesFirstNumberOfOutput(void)
+{
+    static const char *const lines[] =
+    {
+        "let b getb", "echo $b", NULL
+    };
+
+    define("t", lines);
+    TEST_ASSERT_EQUAL(0, script_run("t"));
+    TEST_ASSERT_EQUAL_STRING("42\n", out);
+}
+
+void
+test_CompileErrors(void)
+{
+    static const struct
+    {
+        const char *line, *err;
+    } bad[] =
+    {
+        {"frob", "unknown command"},
+        {"net", "group without command"},
+        {"getb 1 2", "too many args"},
+        {"set n 1x", "bad operand"},
+        {"set n 0x1g", "bad number"},
+        {"set n 1 ^ 2", "bad operator"},
+        {"set n 1 +", "bad expression"},
+        {"set N 1", "bad assignment"},
+        {"end", "'end' without block"},
+        {"else", "'else' without 'if'"},
+        {"loop 1", "missing 'end'"}
+    };
+    const char *lines[2];
+    char msg[64];
+    unsigned int i;
+
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+    {
+        setUp();
+        lines[0] = bad[i].line;
+        lines[1] = NULL;
+        define("t", lines);
+        sprintf(msg, "** Script error, line %d: %s **\n",
+                strcmp(bad[i].err, "missing 'end'") == 0 ? 2 : 1, bad[i].err);
+        TEST_ASSERT_EQUAL_STRING(msg, out);
+        TEST_ASSERT_EQUAL(1, script_run("t"));
+    }
+}
+
+void
+test_FailedRedefinitionKeepsOldScript(void)
+{
+    static const char *const good[] = {"echo old", NULL};
+    static const char *const bad[] = {"echo new", "frob", "echo more", NULL};
+
+    define("t", good);
+    define("t", bad);
+    setUp();
+    TEST_ASSERT_EQUAL(0, script_run("t"));
+    TEST_ASSERT_EQUAL_STRING("old\n", out);
+}
+
+void
+test_FailingCommandStopsScript(void)
+{
+    static const char *const lines[] =
+    {
+        "loop 5", "fail", "end", "echo never", NULL
+    };
+
+    define("t", lines);
+    TEST_ASSERT_EQUAL(1, script_run("t"));
+    TEST_ASSERT_EQUAL(1, nfail);
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+void
+test_NestedRunIsRefused(void)
+{
+    static const char *const inner[] = {"echo inner", NULL};
+    static const char *const outer[] = {"echo outer", "run u", "echo never",
+                                        NULL};
+    char *argv[] = {"run", "t", NULL};
+
+    define("u", inner);
+    define("t", outer);
+    TEST_ASSERT_EQUAL(1, do_run(&cmds[4], 2, argv));
+    TEST_ASSERT_EQUAL_STRING("outer\n** Script aborted **\n"
+                             "** Script aborted **\n", out);
+
+    setUp();
+    TEST_ASSERT_EQUAL(0, script_run("u"));
+    TEST_ASSERT_EQUAL_STRING("inner\n", out);
+}
+
+void
+test_RunUnknownScript(void)
+{
+    char *argv[] = {"run", "nope", NULL};
+
+    TEST_ASSERT_EQUAL(1, script_run("nope"));
+    TEST_ASSERT_EQUAL(1, do_run(&cmds[4], 2, argv));
+    TEST_ASSERT_EQUAL_STRING("Unknown script 'nope'\n", out);
+}
+
+void
+test_CancelAbortsScript(void)
+{
+    static const char *const lines[] =
+    {
+        "loop 100", "echo x", "cancel", "end", NULL
+    };
+
+    define("t", lines);
+    TEST_ASSERT_EQUAL(1, script_run("t"));
+    TEST_ASSERT_EQUAL_STRING("x\n", out);
+
+    deadline_token = CANCEL_NONE;
+    TEST_ASSERT_EQUAL(1, script_run("t"));          /* not left running */
+}
+
+void
+test_NumericEdges(void)
+{
+    static const char *const lines[] =
+    {
+        "set a 0x7fffffff",
+        "set a a + 1",
+        "echo $a",
+        "set b 0x80000000",
+        "echo $b",
+        "set c -7 % 3",
+        "echo $c",
+        "set d 7 / 0",
+        "set e 7 % 0",
+        "echo $d $e",
+        "set f -2147483648",
+        "echo $f",
+        NULL
+    };
+    char expect[128];
+
+    define("t", lines);
+    TEST_ASSERT_EQUAL_STRING("", out);
+    TEST_ASSERT_EQUAL(0, script_run("t"));
+    sprintf(expect, "%ld\n%ld\n-1\n0 0\n-2147483648\n",
+            (long)(0x7fffffffUL + 1), (long)0x80000000UL);
+    TEST_ASSERT_EQUAL_STRING(expect, out);
+}
+
+void
+test_NumberOutOfRange(void)
+{
+    static const char *const dec[] = {"set a 99999999999999999999", NULL};
+    static const char *const hex[] = {"set a 0x1ffffffffffffffff", NULL};
+
+    define("t", dec);
+    TEST_ASSERT_EQUAL_STRING("** Script error, line 1: bad operand **\n", out);
+    setUp();
+    define("t", hex);
+    TEST_ASSERT_EQUAL_STRING("** Script error, line 1: bad number **\n", out);
+    TEST_ASSERT_EQUAL(1, script_run("t"));
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,158 @@
+/**
+ *  \file   test_sesrec.c
+ *  \brief  Unit test for session record and replay modules.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "unity.h"
+#include "mytypes.h"
+#include "contick.h"
+#include "sesrec.h"
+#include "sesrep.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static unsigned char log[1024];
+static unsigned int len;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+sink(const unsigned char *p, unsigned int n)
+{
+    memcpy(&log[len], p, n);
+    len += n;
+}
+
+static void
+record_session(void)
+{
+    sesrec_start(sink);
+    sesrec_rx('l');
+    sesrec_tx("l", 1);
+    sesrec_rx('s');
+    sesrec_tx("s", 1);
+    contick_tick();
+    sesrec_rx('\r');
+    sesrec_tx("\r\nok\r\n>>", 8);
+    sesrec_stop();
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    len = 0;
+    ctick = 0;
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_HeaderAndRecords(void)
+{
+    sesrec_start(sink);
+    sesrec_rx('a');
+    sesrec_rx('b');
+    contick_tick();
+    contick_tick();
+    sesrec_tx("xyz", 3);
+    sesrec_stop();
+
+    TEST_ASSERT_EQUAL(7 + 4 + 5, len);
+    TEST_ASSERT_EQUAL_MEMORY("SREC", log, 4);
+    TEST_ASSERT_EQUAL(SESREC_VERSION, log[4]);
+    TEST_ASSERT_EQUAL(SESREC_TAG_RX | 1, log[7]);
+    TEST_ASSERT_EQUAL(0, log[8]);
+    TEST_ASSERT_EQUAL_MEMORY("ab", &log[9], 2);
+    TEST_ASSERT_EQUAL(SESREC_TAG_TX | 2, log[11]);
+    TEST_ASSERT_EQUAL(2, log[12]);
+    TEST_ASSERT_EQUAL_MEMORY("xyz", &log[13], 3);
+}
+
+void
+test_NothingIsRecordedWhileStopped(void)
+{
+    sesrec_rx('a');
+    sesrec_tx("xyz", 3);
+    TEST_ASSERT_EQUAL(0, len);
+}
+
+void
+test_LongOutputIsSplit(void)
+{
+    char buf[SESREC_CHUNK + 1];
+
+    memset(buf, 'x', sizeof(buf));
+    sesrec_start(sink);
+    sesrec_tx(buf, sizeof(buf));
+    sesrec_stop();
+
+    TEST_ASSERT_EQUAL(7 + 2 + SESREC_CHUNK + 2 + 1, len);
+    TEST_ASSERT_EQUAL(SESREC_TAG_TX | (SESREC_CHUNK - 1), log[7]);
+}
+
+void
+test_ReplayMatchingSession(void)
+{
+    SesRepStat st;
+    const char *out = "ls\r\nok\r\n>>";
+
+    record_session();
+    TEST_ASSERT_EQUAL(SESREP_OK, sesrep_open(log, len, SESREP_FAST));
+
+    TEST_ASSERT_EQUAL(0, sesrep_tstc());
+    TEST_ASSERT_EQUAL('l', sesrep_getc());
+    TEST_ASSERT_EQUAL(1, sesrep_tstc());    /* waits for the echo */
+    sesrep_putc('l');
+    TEST_ASSERT_EQUAL('s', sesrep_getc());
+    sesrep_putc('s');
+    TEST_ASSERT_EQUAL('\r', sesrep_getc());
+    TEST_ASSERT_TRUE(sesrep_done());
+    sesrep_puts(out + 2);
+
+    TEST_ASSERT_EQUAL(0, sesrep_result(&st));
+    TEST_ASSERT_EQUAL(3, st.rx);
+    TEST_ASSERT_EQUAL(10, st.tx);
+    TEST_ASSERT_EQUAL(10, st.expected);
+}
+
+void
+test_ReplayReportsMismatch(void)
+{
+    SesRepStat st;
+
+    record_session();
+    TEST_ASSERT_EQUAL(SESREP_OK, sesrep_open(log, len, SESREP_FAST));
+    sesrep_puts("ls\r\nko");
+
+    TEST_ASSERT_EQUAL(1, sesrep_result(&st));
+    TEST_ASSERT_EQUAL(4, st.first);
+}
+
+void
+test_RejectsBadLog(void)
+{
+    record_session();
+    log[0] = 'X';
+    TEST_ASSERT_EQUAL(SESREP_BAD_HEADER, sesrep_open(log, len, SESREP_FAST));
+    log[0] = 'S';
+    TEST_ASSERT_EQUAL(SESREP_BAD_RECORD, 
+                      sesrep_open(log, len - 1, SESREP_FAST));
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,132 @@
+/**
+ *  \file   test_shmring.c
+ *  \brief  Unit test for shared memory transport.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Both sides are mapped by this process, at different addresses.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "unity.h"
+#include "shmring.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+#define BULK_LEN                (3 * SHMRING_SIZE + 100)
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static char name[32];
+static ShmLink *shell, *tool;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    sprintf(name, "/simshell-test-%d", (int)getpid());
+    shell = shmring_open(name, SHMRING_SHELL);
+    TEST_ASSERT_NOT_NULL(shell);
+    tool = shmring_open(name, SHMRING_TOOL);
+    TEST_ASSERT_NOT_NULL(tool);
+}
+
+void 
+tearDown(void)
+{
+    shmring_close(tool);
+    shmring_close(shell);
+}
+
+void
+test_BothDirections(void)
+{
+    const Transport *t;
+    char buf[16];
+
+    t = shmring_transport(shell);
+    TEST_ASSERT_EQUAL_PTR(shell, t->ctx);
+    TEST_ASSERT_FALSE(t->poll(t->ctx));
+
+    TEST_ASSERT_EQUAL(5, shmring_write(tool, "help\r", 5));
+    TEST_ASSERT_TRUE(t->poll(t->ctx));
+    TEST_ASSERT_EQUAL(5, t->read(t->ctx, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("help\r", buf, 5);
+    TEST_ASSERT_FALSE(t->poll(t->ctx));
+
+    TEST_ASSERT_EQUAL(3, t->write(t->ctx, ">>\n", 3));
+    TEST_ASSERT_FALSE(shmring_poll(shell));
+    TEST_ASSERT_TRUE(shmring_poll(tool));
+    TEST_ASSERT_EQUAL(3, shmring_read(tool, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY(">>\n", buf, 3);
+}
+
+void
+test_StopWhenFull(void)
+{
+    static unsigned char data[SHMRING_SIZE + 10];
+
+    TEST_ASSERT_EQUAL(SHMRING_SIZE, shmring_write(shell, data, 
+                                                  sizeof(data)));
+    TEST_ASSERT_EQUAL(0, shmring_write(shell, data, 1));
+    TEST_ASSERT_EQUAL(10, shmring_read(tool, data, 10));
+    TEST_ASSERT_EQUAL(10, shmring_write(shell, data, sizeof(data)));
+}
+
+void
+test_BulkWrapsAround(void)
+{
+    static unsigned char data[BULK_LEN], got[BULK_LEN];
+    unsigned int i, sent, recv;
+
+    for (i = 0; i < BULK_LEN; ++i)
+    {
+        data[i] = (unsigned char)(i * 13 + 1);
+    }
+    for (sent = recv = 0; recv < BULK_LEN; )
+    {
+        sent += shmring_write(shell, data + sent, 
+                              BULK_LEN - sent < 1000 ? BULK_LEN - sent : 1000);
+        recv += shmring_read(tool, got + recv, 700);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(data, got, BULK_LEN);
+}
+
+void
+test_TellAttachedTools(void)
+{
+    const Transport *t;
+    ShmLink *other;
+
+    t = shmring_transport(shell);
+    TEST_ASSERT_TRUE(t->attached(t->ctx));
+    other = shmring_open(name, SHMRING_TOOL);
+    TEST_ASSERT_NOT_NULL(other);
+    shmring_close(tool);
+    TEST_ASSERT_TRUE(t->attached(t->ctx));
+    shmring_close(other);
+    TEST_ASSERT_FALSE(t->attached(t->ctx));
+    tool = shmring_open(name, SHMRING_TOOL);
+    TEST_ASSERT_TRUE(t->attached(t->ctx));
+}
+
+void
+test_AttachNeedsShell(void)
+{
+    TEST_ASSERT_NULL(shmring_open("/simshell-test-none", SHMRING_TOOL));
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -10,25 +10,191 @@
  */
 
 /* --------------------------------- Notes --------------------------------- */
+/*
+ *  Input is typed from a string through the serial line mock and echo
+ *  is kept in a buffer. Commands come from a table of this test, looked
+ *  up by exact name.
+ */
+
 /* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
 #include "unity.h"
 #include "simshell.h"
+#include "cmdarg.h"
+#include "result.h"
+#include "tahead.h"
+#include "script.h"
 #include "Mock_shellser.h"
 
 /* ----------------------------- Local macros ------------------------------ */
 /* ------------------------------- Constants ------------------------------- */
 /* ---------------------------- Local data types --------------------------- */
 /* ---------------------------- Global variables --------------------------- */
+volatile unsigned char deadline_token;
+
 /* ---------------------------- Local variables ---------------------------- */
+static const char *in;
+static unsigned int nin;
+static char out[512];
+static unsigned int nout;
+static int nstat;
+static MInt stat_argc;
+static char stat_arg[8];
+
 /* ----------------------- Local function prototypes ----------------------- */
+void conser_putc(const char c);
+void conser_puts(const char *s);
+int myprintf(int port, const char *fmt, ...);
+static MInt do_stat(const CMD_TABLE *p, MInt argc, char *argv[]);
+
 /* ---------------------------- Local functions ---------------------------- */
+static const CMD_TABLE cmds[] =
+{
+    MK_CMD_TBL_ENTRY("stat", 4, 2, do_stat, "stat\t- counters\n", NULL),
+    MK_CMD_TBL_ENTRY(NULL, 0, 0, NULL, NULL, NULL)
+};
+
+static MInt
+do_stat(const CMD_TABLE *p, MInt argc, char *argv[])
+{
+    ++nstat;
+    stat_argc = argc;
+    strcpy(stat_arg, argc > 1 ? argv[1] : "");
+    return 0;
+}
+
+static MUInt
+tstc(int ncalls)
+{
+    return in[nin] != '\0' ? 0 : 1;
+}
+
+static MUInt
+getc_in(int ncalls)
+{
+    return (unsigned char)in[nin++];
+}
+
+static void
+putc_out(const char c, int ncalls)
+{
+    if (nout < sizeof(out) - 1)
+    {
+        out[nout++] = c;
+    }
+}
+
+static void
+puts_out(const char *s, int ncalls)
+{
+    while (*s != '\0')
+    {
+        putc_out(*s++, ncalls);
+    }
+}
+
+/**
+ *  \brief
+ *  Type a string on console, until the shell has read all of it.
+ */
+static void
+type(const char *s)
+{
+    in = s;
+    nin = 0;
+    while (in[nin] != '\0')
+    {
+        simshell_process(0);
+    }
+}
+
+static unsigned int
+bells(void)
+{
+    unsigned int i, nbell;
+
+    for (i = nbell = 0; i < nout; ++i)
+    {
+        nbell += out[i] == '\a';
+    }
+    return nbell;
+}
+
 /* ---------------------------- Global functions --------------------------- */
-void 
+void
+conser_putc(const char c)
+{
+    putc_out(c, 0);
+}
+
+void
+conser_puts(const char *s)
+{
+    puts_out(s, 0);
+}
+
+int
+myprintf(int port, const char *fmt, ...)
+{
+    char buf[128];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    puts_out(buf, 0);
+    return 0;
+}
+
+const CMD_TABLE *
+find_cmd_in(const CMD_TABLE *tbl, const char *cmd)
+{
+    for (; tbl->name != NULL; ++tbl)
+    {
+        if (strcmp(tbl->name, cmd) == 0)
+        {
+            return tbl;
+        }
+    }
+    return NULL;
+}
+
+const CMD_TABLE *
+find_tbl_cmd(const char *cmd)
+{
+    return find_cmd_in(cmds, cmd);
+}
+
+const CMD_TABLE *
+find_cmd(const char *cmd)
+{
+    return find_cmd_in(cmds, cmd);
+}
+
+void
+list_cmds(const CMD_TABLE *tbl)
+{
+}
+
+void
 setUp(void)
 {
+    shellser_tstc_StubWithCallback(tstc);
+    shellser_getc_StubWithCallback(getc_in);
+    shellser_putc_StubWithCallback(putc_out);
+    shellser_puts_StubWithCallback(puts_out);
+    simshell_set_linemode(LINE_EDIT);
+    simshell_init();
+    memset(out, 0, sizeof(out));
+    nout = 0;
+    nstat = 0;
+    stat_argc = 0;
+    stat_arg[0] = '\0';
 }
 
-void 
+void
 tearDown(void)
 {
 }
@@ -36,8 +202,100 @@ tearDown(void)
 void
 test_Init(void)
 {
-    simshell_init();
+    TEST_ASSERT_EQUAL(0, nstat);
+}
+
+void
+test_DispatchTypedLine(void)
+{
+    type("stat 1\r");
+    TEST_ASSERT_EQUAL(1, nstat);
+    TEST_ASSERT_EQUAL(2, stat_argc);
+    TEST_ASSERT_EQUAL_STRING("1", stat_arg);
+    TEST_ASSERT_EQUAL(0, bells());
+}
+
+void
+test_UnknownCommandRingsBell(void)
+{
+    type("xyz ");
+    TEST_ASSERT_EQUAL(1, bells());
+    type("1\r");
+    TEST_ASSERT_EQUAL(0, nstat);
+}
+
+void
+test_BackspaceRetypeCommandName(void)
+{
+    type("stax\b\bat 2\r");
+    TEST_ASSERT_EQUAL(1, nstat);
+    TEST_ASSERT_EQUAL_STRING("2", stat_arg);
+    TEST_ASSERT_EQUAL(0, bells());
+}
+
+void
+test_BackspaceOverSeparatorJoinsName(void)
+{
+    type("st at\x7f\x7f\x7f" "at 3\r");
+    TEST_ASSERT_EQUAL(1, bells());              /* for "st " */
+    TEST_ASSERT_EQUAL(1, nstat);
+    TEST_ASSERT_EQUAL(2, stat_argc);
+    TEST_ASSERT_EQUAL_STRING("3", stat_arg);
+}
+
+void
+test_BackspaceWrongNameThenRetype(void)
+{
+    type("xyz \b\b\b\bstat 4\r");
+    TEST_ASSERT_EQUAL(1, bells());
+    TEST_ASSERT_EQUAL(1, nstat);
+    TEST_ASSERT_EQUAL_STRING("4", stat_arg);
+}
+
+void
+test_EraseWordRetypeCommandName(void)
+{
+    type("sta 5\x17\x17stat 6\r");
+    TEST_ASSERT_EQUAL(1, bells());              /* for "sta " */
+    TEST_ASSERT_EQUAL(1, nstat);
+    TEST_ASSERT_EQUAL(2, stat_argc);
+    TEST_ASSERT_EQUAL_STRING("6", stat_arg);
+}
+
+void
+test_EraseArgumentKeepsCommandName(void)
+{
+    type("stat 7\x17 8\r");             /* ^W takes the space too */
+    TEST_ASSERT_EQUAL(0, bells());
+    TEST_ASSERT_EQUAL(1, nstat);
+    TEST_ASSERT_EQUAL_STRING("8", stat_arg);
+}
 
+void
+test_EraseLineRetypeCommandName(void)
+{
+    type("bogus 9\x15stat 10\r");
+    TEST_ASSERT_EQUAL(1, bells());              /* for "bogus " */
+    TEST_ASSERT_EQUAL(1, nstat);
+    TEST_ASSERT_EQUAL(2, stat_argc);
+    TEST_ASSERT_EQUAL_STRING("10", stat_arg);
+}
+
+void
+test_ScriptKeywordsDontRingBell(void)
+{
+#if SCRIPT
+    TEST_ASSERT_EQUAL(0, script_define("t"));
+    type("loop 2\rstat 1\rend\r.\r");
+    TEST_ASSERT_FALSE(script_defining());
+    TEST_ASSERT_EQUAL(0, bells());
+    TEST_ASSERT_EQUAL(0, nstat);
+    TEST_ASSERT_EQUAL(0, script_run("t"));
+    TEST_ASSERT_EQUAL(2, nstat);
+    script_delete("t");
+#else
+    TEST_IGNORE_MESSAGE("SCRIPT is off");
+#endif
 }
 
 /* ------------------------------ End of file ------------------------------ */
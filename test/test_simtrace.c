@@ -0,0 +1,164 @@
+/**
+ *  \file   test_simtrace.c
+ *  \brief  Unit test for the trace ring of command shell.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Events are stored as SIMTRACE_EVT() does, so the ring is tested even
+ *  when the tracepoints are compiled out.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <limits.h>
+#include "unity.h"
+#include "simtrace.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static SimTraceEvt evts[SIMTRACE_SIZE];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+put(unsigned char ev, uintptr_t arg)
+{
+    SimTraceEvt *evt = &simtrace_ring[simtrace_head & (SIMTRACE_SIZE - 1)];
+
+    evt->ts = 0;
+    evt->arg = arg;
+    evt->ev = ev;
+    SIMTRACE_BARRIER();
+    ++simtrace_head;
+}
+
+static void
+put_many(unsigned int n)
+{
+    unsigned int i;
+
+    for (i = 0; i < n; ++i)
+    {
+        put(TRC_RX, i);
+    }
+}
+
+/**
+ *  \brief
+ *  Check evts holds n events whose args follow each other up to last.
+ */
+static void
+check_run(unsigned int n, uintptr_t last)
+{
+    unsigned int i;
+
+    for (i = 0; i < n; ++i)
+    {
+        TEST_ASSERT_EQUAL(last - (n - 1) + i, evts[i].arg);
+    }
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+setUp(void)
+{
+    simtrace_head = 0;
+    simtrace_clear();
+}
+
+void
+tearDown(void)
+{
+}
+
+void
+test_EmptyRing(void)
+{
+    TEST_ASSERT_EQUAL(0, simtrace_snapshot(evts, SIMTRACE_SIZE));
+}
+
+void
+test_EventsInOrder(void)
+{
+    put(TRC_LINE, 5);
+    put(TRC_PARSE, 2);
+    put(TRC_EXIT, 0);
+
+    TEST_ASSERT_EQUAL(3, simtrace_snapshot(evts, SIMTRACE_SIZE));
+    TEST_ASSERT_EQUAL(TRC_LINE, evts[0].ev);
+    TEST_ASSERT_EQUAL(5, evts[0].arg);
+    TEST_ASSERT_EQUAL(TRC_PARSE, evts[1].ev);
+    TEST_ASSERT_EQUAL(TRC_EXIT, evts[2].ev);
+}
+
+void
+test_MaxKeepsLatest(void)
+{
+    put_many(10);
+
+    TEST_ASSERT_EQUAL(4, simtrace_snapshot(evts, 4));
+    check_run(4, 9);
+}
+
+void
+test_FullRingLeavesSlotBeingWritten(void)
+{
+    put_many(SIMTRACE_SIZE);
+
+    TEST_ASSERT_EQUAL(SIMTRACE_SIZE - 1,
+                      simtrace_snapshot(evts, SIMTRACE_SIZE));
+    check_run(SIMTRACE_SIZE - 1, SIMTRACE_SIZE - 1);
+}
+
+void
+test_Wraparound(void)
+{
+    put_many(3 * SIMTRACE_SIZE + 5);
+
+    TEST_ASSERT_EQUAL(SIMTRACE_SIZE - 1,
+                      simtrace_snapshot(evts, SIMTRACE_SIZE));
+    check_run(SIMTRACE_SIZE - 1, 3 * SIMTRACE_SIZE + 4);
+}
+
+void
+test_HeadCounterWraps(void)
+{
+    simtrace_head = ULONG_MAX - 3;
+    simtrace_clear();
+    put_many(10);
+
+    TEST_ASSERT_EQUAL(10, simtrace_snapshot(evts, SIMTRACE_SIZE));
+    check_run(10, 9);
+}
+
+void
+test_ClearDiscardsStoredEvents(void)
+{
+    put_many(SIMTRACE_SIZE + 3);
+    simtrace_clear();
+    TEST_ASSERT_EQUAL(0, simtrace_snapshot(evts, SIMTRACE_SIZE));
+
+    put(TRC_PROMPT, 7);
+    put(TRC_RX, 8);
+    TEST_ASSERT_EQUAL(2, simtrace_snapshot(evts, SIMTRACE_SIZE));
+    check_run(2, 8);
+}
+
+void
+test_EventNames(void)
+{
+    TEST_ASSERT_EQUAL_STRING("rx", simtrace_name(TRC_RX));
+    TEST_ASSERT_EQUAL_STRING("prompt", simtrace_name(TRC_PROMPT));
+    TEST_ASSERT_EQUAL_STRING("?", simtrace_name(TRC_NUM_EVENTS));
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,144 @@
+/**
+ *  \file   test_tagreq.c
+ *  \brief  Unit test for tagged requests.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "unity.h"
+#include "tagreq.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static char out[256];
+static unsigned int nout;
+
+/* ----------------------- Local function prototypes ----------------------- */
+int myprintf(int port, const char *fmt, ...);
+
+/* ---------------------------- Local functions ---------------------------- */
+static void
+begin(const char *req, int rc, const char *cmd)
+{
+    char buf[32], *line;
+
+    strcpy(buf, req);
+    line = buf;
+    TEST_ASSERT_EQUAL(rc, tagreq_begin(&line));
+    TEST_ASSERT_EQUAL_STRING(cmd, line);
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+myprintf(int port, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(out + nout, sizeof(out) - nout, fmt, ap);
+    va_end(ap);
+    nout += n;
+    return n;
+}
+
+void
+setUp(void)
+{
+    memset(out, 0, sizeof(out));
+    nout = 0;
+}
+
+void
+tearDown(void)
+{
+}
+
+void
+test_TagIsTakenOff(void)
+{
+    begin("7 getb 3", 0, " getb 3");
+    tagreq_end(0);
+    TEST_ASSERT_EQUAL_STRING("@7\n!7 0\n", out);
+}
+
+void
+test_LargestTagAndTab(void)
+{
+    begin("65535\tstat", 0, "\tstat");
+    tagreq_end(-1);
+    TEST_ASSERT_EQUAL_STRING("@65535\n!65535 -1\n", out);
+}
+
+void
+test_BadTags(void)
+{
+    static const char *const bad[] =
+    {
+        "0 stat", "65536 stat", "99999999999999999999 stat", "stat",
+        "7stat", "7", " 7 stat"
+    };
+    unsigned int i;
+
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+    {
+        setUp();
+        begin(bad[i], 1, bad[i]);
+        TEST_ASSERT_EQUAL_STRING("!0 -1\n", out);
+    }
+}
+
+void
+test_DeferredCompletesLater(void)
+{
+    unsigned int tag;
+
+    begin("7 slow", 0, " slow");
+    tag = tagreq_defer();
+    TEST_ASSERT_EQUAL(7, tag);
+    tagreq_end(0);
+    begin("8 stat", 0, " stat");
+    tagreq_end(0);
+
+    TEST_ASSERT_EQUAL(0, tagreq_resume(tag));
+    myprintf(0, "done\n");
+    tagreq_done(tag, 0);
+    TEST_ASSERT_EQUAL_STRING("@7\n@8\n!8 0\n@7\ndone\n!7 0\n", out);
+}
+
+void
+test_NoDeferOutsideRequest(void)
+{
+    TEST_ASSERT_EQUAL(0, tagreq_defer());
+}
+
+void
+test_ResumeWaitsForOpenRequest(void)
+{
+    unsigned int tag;
+
+    begin("7 slow", 0, " slow");
+    tag = tagreq_defer();
+    tagreq_end(0);
+
+    begin("8 stat", 0, " stat");
+    TEST_ASSERT_EQUAL(1, tagreq_resume(tag));
+    tagreq_end(0);
+    TEST_ASSERT_EQUAL(0, tagreq_resume(tag));
+    tagreq_done(tag, -1);
+    TEST_ASSERT_EQUAL_STRING("@7\n@8\n!8 0\n@7\n!7 -1\n", out);
+}
+
+/* ------------------------------ End of file ------------------------------ */
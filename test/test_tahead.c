@@ -0,0 +1,300 @@
+/**
+ *  \file   test_tahead.c
+ *  \brief  Unit test for type-ahead queue.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "mytypes.h"
+#include "tahead.h"
+#include "flowctl.h"
+#include "Mock_shellser.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+#define NUM_LINES               1000
+
+/** Bytes received per tick, about 9600 bps with a 1 ms tick */
+#define BYTES_PER_TICK          1
+
+/** Ticks a handler keeps the shell busy, more than a line takes */
+#define HANDLER_TICKS           40
+
+/** 
+ * Receive queue of the UART. Without flow control the host holds on 
+ * while it is full, with it bytes arriving then are lost.
+ */
+#define UART_FIFO               64
+
+/** Give up if the paste is not through by then */
+#define MAX_TICKS               (NUM_LINES * 2 * HANDLER_TICKS)
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static char line[TAHEAD_LINE + 1];
+
+/** Pasted text, bytes sent so far and bytes waiting in the UART */
+static char paste[NUM_LINES * 20];
+static unsigned int total, sent, held, overruns;
+static char fifo[UART_FIFO];
+static unsigned int fifo_in, fifo_out;
+static unsigned long ticks;
+
+/** The UART counts input for flow control, and the host is told to send */
+static int flowctl, ready;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+put_string(const char *s)
+{
+    while (*s)
+        tahead_put(*s++);
+}
+
+static MUInt
+uart_tstc(int ncalls)
+{
+    (void)ncalls;
+    return fifo_in != fifo_out ? 0 : 1;     /* 0 if a byte is waiting */
+}
+
+static MUInt
+uart_getc(int ncalls)
+{
+    (void)ncalls;
+    if (flowctl)
+    {
+        flowctl_take();                     /* as conser_getc() does */
+    }
+    return (MUInt)(unsigned char)fifo[fifo_out++ % UART_FIFO];
+}
+
+/* One tick of time, the host sends at line rate unless held */
+static void
+tick(void)
+{
+    int i;
+
+    for (i = 0; i < BYTES_PER_TICK && sent < total; ++i, ++sent)
+    {
+        if (flowctl && !ready)
+        {
+            ++held;                         /* XOFF seen */
+            break;
+        }
+        if (fifo_in - fifo_out == UART_FIFO)
+        {
+            if (flowctl)
+            {
+                ++overruns;
+                continue;
+            }
+            ++held;
+            break;
+        }
+        fifo[fifo_in++ % UART_FIFO] = paste[sent];
+        if (flowctl)
+        {
+            flowctl_rx();                   /* as the receive isr does */
+        }
+    }
+    ++ticks;
+}
+
+/* 
+ * Paste the lines, each one dispatched when the shell is idle and run 
+ * by a handler that drains input now and then.
+ */
+static unsigned int
+paste_lines(void)
+{
+    char expected[TAHEAD_LINE + 1];
+    unsigned int i, received;
+    char *p;
+
+    for (i = 0, p = paste; i < NUM_LINES; ++i)
+    {
+        p += sprintf(p, "setb %u 0x%04x\r\n", i, i * 7);
+    }
+    total = p - paste;
+    sent = held = overruns = fifo_in = fifo_out = 0;
+    ticks = 0;
+    shellser_tstc_StubWithCallback(uart_tstc);
+    shellser_getc_StubWithCallback(uart_getc);
+
+    for (received = 0; received < NUM_LINES && ticks < MAX_TICKS; )
+    {
+        /* Shell is idle, it dispatches the oldest line as the shell does */
+        tahead_fill();
+        if (tahead_get(line) < 0)
+        {
+            tick();
+            continue;
+        }
+        sprintf(expected, "setb %u 0x%04x", received, received * 7);
+        TEST_ASSERT_EQUAL_STRING(expected, line);
+        ++received;
+
+        /* Its handler runs while the rest of the paste arrives */
+        tahead_busy(1);
+        for (i = 0; i < HANDLER_TICKS; ++i)
+        {
+            tick();
+            tahead_drain();
+        }
+        tahead_busy(0);
+    }
+    return received;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+conser_flow(int r)
+{
+    ready = r;
+}
+
+void 
+setUp(void)
+{
+    tahead_init();
+    flowctl = 0;
+    flowctl_reset();
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_QueueLinesInOrder(void)
+{
+    put_string("getb 1\r\nsetb 2\n");
+
+    TEST_ASSERT_TRUE(tahead_pending());
+    TEST_ASSERT_EQUAL(6, tahead_get(line));
+    TEST_ASSERT_EQUAL_STRING("getb 1", line);
+    TEST_ASSERT_EQUAL(6, tahead_get(line));
+    TEST_ASSERT_EQUAL_STRING("setb 2", line);
+    TEST_ASSERT_EQUAL(-1, tahead_get(line));
+    TEST_ASSERT_FALSE(tahead_pending());
+}
+
+void
+test_EditLineInProgress(void)
+{
+    put_string("geta\b\bxb\x7F" "b 3\r");
+    put_string("junk\x15" "inp 1\r");
+
+    TEST_ASSERT_EQUAL(6, tahead_get(line));
+    TEST_ASSERT_EQUAL_STRING("gexb 3", line);
+    TEST_ASSERT_EQUAL(5, tahead_get(line));
+    TEST_ASSERT_EQUAL_STRING("inp 1", line);
+}
+
+void
+test_TakeLineInProgress(void)
+{
+    put_string("stat\rout");
+
+    TEST_ASSERT_EQUAL(4, tahead_get(line));
+    TEST_ASSERT_EQUAL(-1, tahead_get(line));
+    TEST_ASSERT_TRUE(tahead_pending());
+    TEST_ASSERT_EQUAL(3, tahead_partial(line));
+    TEST_ASSERT_EQUAL_STRING_LEN("out", line, 3);
+    TEST_ASSERT_FALSE(tahead_pending());
+}
+
+void
+test_CtrlCDiscardsEverything(void)
+{
+    put_string("stat\rout\x03");
+
+    TEST_ASSERT_FALSE(tahead_pending());
+}
+
+void
+test_DropLongLine(void)
+{
+    TAheadStat st;
+    int i;
+
+    for (i = 0; i < TAHEAD_LINE + 5; ++i)
+    {
+        tahead_put('x');
+    }
+    put_string("\rstat\r");
+
+    TEST_ASSERT_EQUAL(4, tahead_get(line));
+    TEST_ASSERT_EQUAL_STRING("stat", line);
+    tahead_stat(&st);
+    TEST_ASSERT_EQUAL(1, st.lines);
+    TEST_ASSERT_EQUAL(1, st.toolong);
+}
+
+void
+test_CountOverflows(void)
+{
+    TAheadStat st;
+    int i;
+
+    for (i = 0; i < TAHEAD_SIZE / 7 + 2; ++i)
+    {
+        put_string("echo 1\r");                     /* 7 bytes in arena */
+    }
+    tahead_stat(&st);
+    TEST_ASSERT_EQUAL(TAHEAD_SIZE / 7, st.lines);
+    TEST_ASSERT_EQUAL(2, st.overflows);
+
+    /* Room again once lines are dispatched */
+    TEST_ASSERT_EQUAL(6, tahead_get(line));
+    put_string("echo 2\r");
+    tahead_stat(&st);
+    TEST_ASSERT_EQUAL(TAHEAD_SIZE / 7 + 1, st.lines);
+}
+
+void
+test_PasteThousandLinesAtLineRate(void)
+{
+    TAheadStat st;
+
+    TEST_ASSERT_EQUAL(NUM_LINES, paste_lines());
+    TEST_ASSERT_TRUE(held > 0);             /* the arena got full */
+
+    tahead_stat(&st);
+    TEST_ASSERT_EQUAL(NUM_LINES, st.lines);
+    TEST_ASSERT_EQUAL(0, st.overflows);
+    TEST_ASSERT_EQUAL(0, st.toolong);
+}
+
+void
+test_FullArenaStopsHostByXoff(void)
+{
+    TAheadStat st;
+    FlowCtlStat fc;
+
+    flowctl = 1;
+    TEST_ASSERT_EQUAL(NUM_LINES, paste_lines());
+
+    flowctl_stat(&fc);
+    TEST_ASSERT_TRUE(fc.xoffs > 0);
+    TEST_ASSERT_TRUE(fc.peak <= UART_FIFO);
+    TEST_ASSERT_EQUAL(0, overruns);
+    tahead_stat(&st);
+    TEST_ASSERT_EQUAL(NUM_LINES, st.lines);
+    TEST_ASSERT_EQUAL(0, st.overflows);
+}
+
+/* ------------------------------ End of file ------------------------------ */
@@ -0,0 +1,223 @@
+/**
+ *  \file   test_vchan.c
+ *  \brief  Unit test for virtual channels.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  The module is wired to itself, every frame it sends comes back as 
+ *  received, so it is its own peer.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <string.h>
+#include "unity.h"
+#include "vchan.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+#define BULK_LEN                1000
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static unsigned char wire[4096];
+static unsigned int nwire;
+
+/** Channel of every data frame, in sending order */
+static unsigned char order[64];
+static unsigned int norder;
+
+/** Bytes taken by the filter */
+static unsigned int ntaken;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+tx(const unsigned char *frame, unsigned int len)
+{
+    unsigned char hdr;
+
+    TEST_ASSERT_TRUE(nwire + len <= sizeof(wire));
+    TEST_ASSERT_EQUAL_HEX8(0, frame[len - 1]);
+    TEST_ASSERT_NULL(memchr(frame, 0, len - 1));
+    memcpy(&wire[nwire], frame, len);
+    nwire += len;
+    hdr = frame[0] == 1 ? 0 : frame[1];     /* first COBS block */
+    if ((hdr & 0x0F) == VCHAN_DATA && norder < sizeof(order))
+    {
+        order[norder++] = hdr >> 4;
+    }
+}
+
+static void
+loopback(void)
+{
+    unsigned int i, n;
+
+    n = nwire;
+    nwire = 0;
+    for (i = 0; i < n; ++i)
+    {
+        vchan_rx(wire[i]);
+    }
+}
+
+static int
+take_ctrlc(unsigned char c)
+{
+    if (c == 0x03)
+    {
+        ++ntaken;
+        return 1;
+    }
+    return 0;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void 
+setUp(void)
+{
+    vchan_init(tx);
+    vchan_filter(VCHAN_SHELL, NULL);
+    nwire = norder = ntaken = 0;
+}
+
+void 
+tearDown(void)
+{
+}
+
+void
+test_SendDataWithZeros(void)
+{
+    static const unsigned char data[] = {0, 1, 0, 0, 0xFF, 2, 0};
+    unsigned char buf[sizeof(data)];
+
+    TEST_ASSERT_EQUAL(sizeof(data), vchan_write(VCHAN_BULK, data, 
+                                                sizeof(data)));
+    vchan_poll();
+    loopback();
+
+    TEST_ASSERT_EQUAL(sizeof(data), vchan_avail(VCHAN_BULK));
+    TEST_ASSERT_EQUAL(sizeof(data), vchan_read(VCHAN_BULK, buf, 
+                                               sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY(data, buf, sizeof(data));
+    TEST_ASSERT_EQUAL(0, vchan_avail(VCHAN_SHELL));
+}
+
+void
+test_ConsoleGoesFirst(void)
+{
+    unsigned char bulk[3 * VCHAN_MTU];
+    char line[2 * VCHAN_MTU];
+
+    memset(bulk, 'b', sizeof(bulk));
+    memset(line, 'c', sizeof(line));
+    vchan_write(VCHAN_BULK, bulk, sizeof(bulk));
+    vchan_write(VCHAN_SHELL, line, sizeof(line));
+    vchan_poll();
+
+    /* Whole console, then one bulk frame per poll */
+    TEST_ASSERT_EQUAL(3, norder);
+    TEST_ASSERT_EQUAL(VCHAN_SHELL, order[0]);
+    TEST_ASSERT_EQUAL(VCHAN_SHELL, order[1]);
+    TEST_ASSERT_EQUAL(VCHAN_BULK, order[2]);
+}
+
+void
+test_BulkStopsWithoutCredit(void)
+{
+    unsigned char data[BULK_LEN], got[BULK_LEN];
+    unsigned int i, sent, recv;
+
+    for (i = 0; i < BULK_LEN; ++i)
+    {
+        data[i] = (unsigned char)(i * 7);
+    }
+
+    /* Nobody reads, the sender stops at VCHAN_BUF bytes */
+    for (sent = 0, i = 0; i < 20; ++i)
+    {
+        sent += vchan_write(VCHAN_BULK, data + sent, BULK_LEN - sent);
+        vchan_poll();
+        loopback();
+    }
+    TEST_ASSERT_EQUAL(VCHAN_BUF, vchan_avail(VCHAN_BULK));
+
+    /* Reading grants credit back and the stream goes on, undamaged */
+    for (recv = 0; recv < BULK_LEN; )
+    {
+        recv += vchan_read(VCHAN_BULK, got + recv, VCHAN_MTU);
+        sent += vchan_write(VCHAN_BULK, data + sent, BULK_LEN - sent);
+        vchan_poll();
+        loopback();
+        TEST_ASSERT_TRUE(vchan_avail(VCHAN_BULK) <= VCHAN_BUF);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(data, got, BULK_LEN);
+}
+
+void
+test_DropMalformedFrames(void)
+{
+    VChanStat before, after;
+    static const unsigned char junk[] = {5, 'a', 0, 0x02, 0x01, 0, 0};
+    unsigned char c;
+    unsigned int i;
+
+    vchan_stat(&before);
+    for (i = 0; i < sizeof(junk); ++i)
+    {
+        vchan_rx(junk[i]);
+    }
+    vchan_stat(&after);
+    TEST_ASSERT_EQUAL(before.bad + 2, after.bad);
+
+    /* Next good frame is taken */
+    vchan_write(VCHAN_SHELL, "x", 1);
+    vchan_poll();
+    loopback();
+    TEST_ASSERT_EQUAL(1, vchan_read(VCHAN_SHELL, &c, 1));
+    TEST_ASSERT_EQUAL('x', c);
+}
+
+void
+test_SyncResetsPeer(void)
+{
+    vchan_write(VCHAN_LOG, "log", 3);
+    vchan_poll();
+    loopback();
+    TEST_ASSERT_EQUAL(3, vchan_avail(VCHAN_LOG));
+
+    vchan_sync();
+    loopback();
+    TEST_ASSERT_EQUAL(0, vchan_avail(VCHAN_LOG));
+}
+
+void
+test_FilterSeesBytesOutOfFrames(void)
+{
+    unsigned char buf[4];
+
+    vchan_filter(VCHAN_SHELL, take_ctrlc);
+    vchan_write(VCHAN_BULK, "\x03\x03", 2);
+    vchan_write(VCHAN_SHELL, "a\x03" "b", 3);
+    vchan_poll();
+    vchan_poll();
+    loopback();
+
+    /* Only the console one is taken, whatever the frame bytes are */
+    TEST_ASSERT_EQUAL(1, ntaken);
+    TEST_ASSERT_EQUAL(2, vchan_read(VCHAN_SHELL, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("ab", buf, 2);
+    TEST_ASSERT_EQUAL(2, vchan_read(VCHAN_BULK, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("\x03\x03", buf, 2);
+}
+
+/* ------------------------------ End of file ------------------------------ */
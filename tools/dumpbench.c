@@ -0,0 +1,165 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   dumpbench.c
+ *  \brief  Host benchmark of memory row formatting.
+ *
+ *  Formats a region as the 'dump' command does, by the row encoder and 
+ *  by a printf per byte, and shows the throughput of both against the 
+ *  time a link takes to send the rows.
+ *
+ *      cc -O2 -Iinc -o dumpbench tools/dumpbench.c src/hexfmt.c
+ *      dumpbench [megabytes] [baud]
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hexfmt.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+/** Sum of output, so that formatting is not optimized out */
+static volatile unsigned long sink;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned long
+by_table(const unsigned char *mem, unsigned long size)
+{
+    char row[HEXFMT_ROWLEN];
+    unsigned long i, out;
+
+    for (i = 0, out = 0; i < size; i += HEXFMT_ROW)
+    {
+        out += hexfmt_row(row, i, mem + i, HEXFMT_ROW, 1);
+        sink += (unsigned char)row[HEXFMT_ADDR + 2];
+    }
+    return out;
+}
+
+static unsigned long
+by_printf(const unsigned char *mem, unsigned long size)
+{
+    char row[HEXFMT_ROWLEN];
+    char *s;
+    unsigned long i, out;
+    unsigned int j;
+
+    for (i = 0, out = 0; i < size; i += HEXFMT_ROW)
+    {
+        s = row + sprintf(row, "%0*lx:", (int)HEXFMT_ADDR, i);
+        for (j = 0; j < HEXFMT_ROW; ++j)
+        {
+            s += sprintf(s, " %02x", mem[i + j]);
+        }
+        s += sprintf(s, "  ");
+        for (j = 0; j < HEXFMT_ROW; ++j)
+        {
+            s += sprintf(s, "%c", mem[i + j] >= 0x20 && mem[i + j] < 0x7F ?
+                                  mem[i + j] : '.');
+        }
+        s += sprintf(s, "\n");
+        out += s - row;
+        sink += (unsigned char)row[HEXFMT_ADDR + 2];
+    }
+    return out;
+}
+
+static void
+report(const char *name, unsigned long size, unsigned long out, double t,
+       unsigned long baud)
+{
+    double link = out * 10.0 / baud;
+
+    printf("%-8s %8.1f MB/s in, %8.1f MB/s out, %8.4f%% of link time "
+           "at %lu baud\n", name, size / t / 1e6, out / t / 1e6,
+           100 * t / link, baud);
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+main(int argc, char *argv[])
+{
+    unsigned long size, baud, out, i;
+    unsigned char *mem;
+    double t;
+
+    size = (argc > 1 ? strtoul(argv[1], NULL, 0) : 16) << 20;
+    baud = argc > 2 ? strtoul(argv[2], NULL, 0) : 115200;
+
+    if (size == 0 || baud == 0 || (mem = malloc(size)) == NULL)
+    {
+        fprintf(stderr, "usage: %s [megabytes] [baud]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < size; ++i)
+    {
+        mem[i] = (unsigned char)(i * 2654435761UL >> 13);
+    }
+
+    t = now();
+    out = by_table(mem, size);
+    report("table", size, out, now() - t, baud);
+
+    t = now();
+    out = by_printf(mem, size);
+    report("printf", size, out, now() - t, baud);
+
+    free(mem);
+    return EXIT_SUCCESS;
+}
+
+/* ------------------------------ End of file ------------------------------ */
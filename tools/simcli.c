@@ -0,0 +1,514 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   simcli.c
+ *  \brief  Host side client of the shell, with local line editing.
+ *
+ *  Lines are edited on host, with history and completion of command 
+ *  names, and only finished lines are sent. The device is switched to raw 
+ *  line mode, so it neither echoes input nor redraws the line, and its 
+ *  prompt only tells the end of command output. Linux only.
+ *
+ *      cc -o simcli tools/simcli.c
+ *      simcli /dev/ttyUSB0 [baud]
+ *
+ *  Keys: left, right, up and down arrows, ^A, ^E, backspace, ^U, TAB 
+ *  completes the command name, ^C clears the line and ^D quits.
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Command names are taken once from the output of 'help', every usage 
+ *  line starts with the name followed by a TAB. Needs the 'echo' command 
+ *  to synchronize with the device.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/** 
+ * Longest line the device keeps, CBSIZE - 2: the shell drops characters 
+ * once n reaches CBSIZE - 2, see the 'n < CBSIZE - 2' check of
+ * process_in_char() in simshell.c.
+ */
+#define LINE_MAX_LEN            30
+
+#define HISTORY                 32
+#define MAX_NAMES               64
+#define RESPONSE_SIZE           8192
+
+/** Give up waiting for the prompt, in seconds */
+#define RESPONSE_TIMEOUT        5
+
+static const char prompt[] = ">>";
+
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static int link_fd;
+static struct termios saved;
+
+static char line[LINE_MAX_LEN + 1];
+static int len, cur;
+
+static char history[HISTORY][LINE_MAX_LEN + 1];
+static int nhist, hpos;
+
+static char names[MAX_NAMES][16];
+static int nnames;
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static speed_t
+baud_rate(long baud)
+{
+    switch (baud)
+    {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        default: return B115200;
+    }
+}
+
+static void
+open_link(const char *path, long baud)
+{
+    struct termios t;
+
+    if ((link_fd = open(path, O_RDWR | O_NOCTTY)) < 0)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    if (tcgetattr(link_fd, &t) == 0)
+    {
+        cfmakeraw(&t);
+        cfsetspeed(&t, baud_rate(baud));
+        tcsetattr(link_fd, TCSANOW, &t);
+    }
+}
+
+static void
+send_str(const char *s)
+{
+    size_t n;
+    ssize_t k;
+
+    for (n = strlen(s); n != 0; s += k, n -= k)
+    {
+        if ((k = write(link_fd, s, n)) < 0)
+        {
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void
+restore_term(void)
+{
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+}
+
+static void
+raw_term(void)
+{
+    struct termios t;
+
+    tcgetattr(STDIN_FILENO, &saved);
+    atexit(restore_term);
+    t = saved;
+    t.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
+    t.c_iflag &= ~(IXON | ICRNL);
+    t.c_cc[VMIN] = 1;
+    t.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &t);
+}
+
+/**
+ *  \brief
+ *  Print device output, with '\n' as "\r\n" for the raw terminal.
+ */
+static void
+put_out(const char *s, size_t n)
+{
+    for (; n != 0; ++s, --n)
+    {
+        if (*s == '\n')
+        {
+            fputc('\r', stdout);
+        }
+        fputc(*s, stdout);
+    }
+}
+
+/**
+ *  \brief
+ *  Read device output up to the prompt, which is left out.
+ *
+ *  \return
+ *  Output length, the prompt not counted.
+ */
+static size_t
+response(char *buf, size_t size)
+{
+    struct timeval tv;
+    fd_set fds;
+    size_t n;
+    ssize_t k;
+
+    for (n = 0; n < size - 1; n += k)
+    {
+        if (n >= 2 && memcmp(&buf[n - 2], prompt, 2) == 0 &&
+            (n == 2 || buf[n - 3] == '\n'))
+        {
+            n -= 2;
+            break;
+        }
+        FD_ZERO(&fds);
+        FD_SET(link_fd, &fds);
+        tv.tv_sec = RESPONSE_TIMEOUT;
+        tv.tv_usec = 0;
+        if (select(link_fd + 1, &fds, NULL, NULL, &tv) <= 0 ||
+            (k = read(link_fd, &buf[n], size - 1 - n)) <= 0)
+        {
+            break;
+        }
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+/**
+ *  \brief
+ *  Switch the device to raw line mode and skip its output up to the 
+ *  answer of a marker echo, to start clean whatever it was doing.
+ */
+static void
+sync_device(void)
+{
+    static char buf[RESPONSE_SIZE];
+    static const char marker[] = "--simcli--\n>>";
+    struct timeval tv;
+    fd_set fds;
+    size_t n;
+    ssize_t k;
+
+    send_str("\x15line raw\recho --simcli--\r");
+    for (n = 0; ; n += k)
+    {
+        buf[n] = '\0';
+        if (strstr(buf, marker) != NULL)
+        {
+            return;
+        }
+        if (n == sizeof(buf) - 1)           /* keep the tail only */
+        {
+            memmove(buf, &buf[n - sizeof(marker)], sizeof(marker));
+            n = sizeof(marker);
+        }
+        FD_ZERO(&fds);
+        FD_SET(link_fd, &fds);
+        tv.tv_sec = RESPONSE_TIMEOUT;
+        tv.tv_usec = 0;
+        if (select(link_fd + 1, &fds, NULL, NULL, &tv) <= 0 ||
+            (k = read(link_fd, &buf[n], sizeof(buf) - 1 - n)) <= 0)
+        {
+            fprintf(stderr, "no answer from device\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void
+fetch_names(void)
+{
+    static char buf[RESPONSE_SIZE];
+    char *s, *tab;
+
+    send_str("help\r");
+    response(buf, sizeof(buf));
+    for (s = strtok(buf, "\n"); s != NULL && nnames < MAX_NAMES; 
+         s = strtok(NULL, "\n"))
+    {
+        if ((tab = strchr(s, '\t')) != NULL && tab[1] == '-' &&
+            (size_t)(tab - s) < sizeof(names[0]))
+        {
+            memcpy(names[nnames], s, tab - s);
+            names[nnames++][tab - s] = '\0';
+        }
+    }
+}
+
+static void
+redraw(void)
+{
+    printf("\r\033[K%s%s", prompt, line);
+    if (len > cur)
+    {
+        printf("\033[%dD", len - cur);
+    }
+    fflush(stdout);
+}
+
+static void
+set_line(const char *s)
+{
+    strcpy(line, s);
+    len = cur = strlen(line);
+}
+
+static void
+complete(void)
+{
+    int i, nmatch, first, k;
+
+    if (memchr(line, ' ', cur) != NULL)     /* only the command name */
+    {
+        return;
+    }
+    for (i = 0, nmatch = 0, first = -1; i < nnames; ++i)
+    {
+        if (strncmp(names[i], line, cur) == 0)
+        {
+            if (first < 0)
+            {
+                first = i;
+            }
+            ++nmatch;
+        }
+    }
+    if (nmatch == 1 && (k = strlen(names[first])) < LINE_MAX_LEN)
+    {
+        memmove(&line[k + 1], &line[cur], len - cur + 1);
+        memcpy(line, names[first], k);
+        line[k] = ' ';
+        len += k + 1 - cur;
+        cur = k + 1;
+        if (len > LINE_MAX_LEN)
+        {
+            line[len = LINE_MAX_LEN] = '\0';
+            cur = cur > len ? len : cur;
+        }
+    }
+    else if (nmatch > 1)
+    {
+        printf("\r\n");
+        for (i = 0; i < nnames; ++i)
+        {
+            if (strncmp(names[i], line, cur) == 0)
+            {
+                printf("%s  ", names[i]);
+            }
+        }
+        printf("\r\n");
+    }
+}
+
+static void
+run_line(void)
+{
+    static char buf[RESPONSE_SIZE];
+    size_t n;
+
+    printf("\r\n");
+    if (len != 0)
+    {
+        if (nhist == 0 || strcmp(history[(nhist - 1) % HISTORY], line) != 0)
+        {
+            strcpy(history[nhist++ % HISTORY], line);
+        }
+        send_str(line);
+        send_str("\r");
+        n = response(buf, sizeof(buf));
+        put_out(buf, n);
+    }
+    hpos = nhist;
+    set_line("");
+}
+
+/**
+ *  \brief
+ *  Handle one key, escape sequences included.
+ *
+ *  \return
+ *  0 to go on, 1 to quit.
+ */
+static int
+key(int c)
+{
+    unsigned char seq[2];
+    int i;
+
+    switch (c)
+    {
+        case '\r':
+        case '\n':
+            run_line();
+            break;
+        case 0x04:                                  /* ^D */
+            if (len == 0)
+            {
+                return 1;
+            }
+            break;
+        case 0x03:                                  /* ^C */
+        case 0x15:                                  /* ^U */
+            set_line("");
+            break;
+        case 0x01:                                  /* ^A */
+            cur = 0;
+            break;
+        case 0x05:                                  /* ^E */
+            cur = len;
+            break;
+        case 0x08:
+        case 0x7F:
+            if (cur != 0)
+            {
+                memmove(&line[cur - 1], &line[cur], len - cur + 1);
+                --cur;
+                --len;
+            }
+            break;
+        case '\t':
+            complete();
+            break;
+        case 0x1B:                                  /* ESC [ x */
+            if (read(STDIN_FILENO, seq, 2) != 2 || seq[0] != '[')
+            {
+                break;
+            }
+            if (seq[1] == 'A' && hpos > 0 && nhist - hpos < HISTORY - 1)
+            {
+                set_line(history[--hpos % HISTORY]);
+            }
+            else if (seq[1] == 'B' && hpos < nhist)
+            {
+                set_line(++hpos < nhist ? history[hpos % HISTORY] : "");
+            }
+            else if (seq[1] == 'C' && cur < len)
+            {
+                ++cur;
+            }
+            else if (seq[1] == 'D' && cur > 0)
+            {
+                --cur;
+            }
+            break;
+        default:
+            if (c >= ' ' && c < 0x7F && len < LINE_MAX_LEN)
+            {
+                for (i = len + 1; i > cur; --i)
+                {
+                    line[i] = line[i - 1];
+                }
+                line[cur++] = (char)c;
+                ++len;
+            }
+            break;
+    }
+    redraw();
+    return 0;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+main(int argc, char *argv[])
+{
+    static char buf[RESPONSE_SIZE];
+    unsigned char c;
+    ssize_t n;
+    fd_set fds;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <serial device> [baud]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    open_link(argv[1], argc > 2 ? atol(argv[2]) : 115200);
+    sync_device();
+    fetch_names();
+
+    raw_term();
+    redraw();
+    for (;;)
+    {
+        FD_ZERO(&fds);
+        FD_SET(STDIN_FILENO, &fds);
+        FD_SET(link_fd, &fds);
+        if (select(link_fd + 1, &fds, NULL, NULL, NULL) < 0)
+        {
+            break;
+        }
+        if (FD_ISSET(link_fd, &fds))            /* logs, above the line */
+        {
+            if ((n = read(link_fd, buf, sizeof(buf))) <= 0)
+            {
+                break;
+            }
+            printf("\r\033[K");
+            put_out(buf, n);
+            redraw();
+        }
+        if (FD_ISSET(STDIN_FILENO, &fds))
+        {
+            if (read(STDIN_FILENO, &c, 1) != 1 || key(c))
+            {
+                break;
+            }
+        }
+    }
+    printf("\r\n");
+    send_str("line edit\r");
+    return EXIT_SUCCESS;
+}
+
+/* ------------------------------ End of file ------------------------------ */
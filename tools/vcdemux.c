@@ -0,0 +1,221 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+/**
+ *  \file   vcdemux.c
+ *  \brief  Host side demultiplexer of virtual channels.
+ *
+ *  Opens the serial link of a board built with VCHAN. The console channel 
+ *  is bound to stdin and stdout, the log channel goes to stderr and the 
+ *  other channels to files named ch<n>.bin.
+ *
+ *      cc -Iinc -o vcdemux tools/vcdemux.c src/vchan.c
+ *      vcdemux /dev/ttyUSB0 [baud]
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+#include "vchan.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+/* ------------------------------- Constants ------------------------------- */
+/* ---------------------------- Local data types --------------------------- */
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static int link_fd;
+static FILE *outs[VCHAN_NUM];
+
+/* ----------------------- Local function prototypes ----------------------- */
+/* ---------------------------- Local functions ---------------------------- */
+static void
+link_tx(const unsigned char *frame, unsigned int len)
+{
+    ssize_t n;
+
+    for (; len != 0; frame += n, len -= n)
+    {
+        if ((n = write(link_fd, frame, len)) < 0)
+        {
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static speed_t
+baud_rate(long baud)
+{
+    switch (baud)
+    {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        default: return B115200;
+    }
+}
+
+static int
+open_link(const char *path, long baud)
+{
+    struct termios t;
+    int fd;
+
+    if ((fd = open(path, O_RDWR | O_NOCTTY)) < 0)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    if (tcgetattr(fd, &t) == 0)
+    {
+        cfmakeraw(&t);
+        cfsetspeed(&t, baud_rate(baud));
+        tcsetattr(fd, TCSANOW, &t);
+    }
+    return fd;
+}
+
+static void
+open_outputs(void)
+{
+    char name[16];
+    unsigned int ch;
+
+    outs[VCHAN_SHELL] = stdout;
+    outs[VCHAN_LOG] = stderr;
+    for (ch = VCHAN_LOG + 1; ch < VCHAN_NUM; ++ch)
+    {
+        sprintf(name, "ch%u.bin", ch);
+        if ((outs[ch] = fopen(name, "wb")) == NULL)
+        {
+            perror(name);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void
+drain_channels(void)
+{
+    unsigned char buf[VCHAN_BUF];
+    unsigned int ch, n;
+
+    for (ch = 0; ch < VCHAN_NUM; ++ch)
+    {
+        while ((n = vchan_read(ch, buf, sizeof(buf))) != 0)
+        {
+            fwrite(buf, 1, n, outs[ch]);
+        }
+        fflush(outs[ch]);
+    }
+}
+
+/* ---------------------------- Global functions --------------------------- */
+int
+main(int argc, char *argv[])
+{
+    unsigned char buf[256];
+    unsigned char line[256];
+    unsigned int nline, k;
+    ssize_t n, i;
+    fd_set fds;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <serial device> [baud]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    link_fd = open_link(argv[1], argc > 2 ? atol(argv[2]) : 115200);
+    open_outputs();
+    vchan_init(link_tx);
+    vchan_sync();
+
+    for (nline = 0; ; )
+    {
+        FD_ZERO(&fds);
+        FD_SET(link_fd, &fds);
+        if (nline == 0)
+        {
+            FD_SET(STDIN_FILENO, &fds);
+        }
+        if (select(link_fd + 1, &fds, NULL, NULL, NULL) < 0)
+        {
+            perror("select");
+            return EXIT_FAILURE;
+        }
+        if (FD_ISSET(link_fd, &fds))
+        {
+            if ((n = read(link_fd, buf, sizeof(buf))) <= 0)
+            {
+                return EXIT_SUCCESS;
+            }
+            for (i = 0; i < n; ++i)
+            {
+                vchan_rx(buf[i]);
+            }
+            drain_channels();
+        }
+        if (nline == 0 && FD_ISSET(STDIN_FILENO, &fds))
+        {
+            if ((n = read(STDIN_FILENO, line, sizeof(line))) <= 0)
+            {
+                return EXIT_SUCCESS;
+            }
+            nline = (unsigned int)n;
+        }
+
+        /* Console input waits here for credit of the board */
+        if (nline != 0)
+        {
+            k = vchan_write(VCHAN_SHELL, line, nline);
+            memmove(line, line + k, nline - k);
+            nline -= k;
+        }
+        vchan_poll();
+    }
+}
+
+/* ------------------------------ End of file ------------------------------ */
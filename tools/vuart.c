@@ -0,0 +1,697 @@
+/* --------------------------------------------------------------------------
+ *
+ *                       Simple Shell for Embedded Systems
+ *                       ---------------------------------
+ *
+ *                       Suitable for tiny embedded systems
+ *
+ *                      Copyright (c) 2020 Leandro Francucci
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Site: https://vortexmakes.com/
+ * e-mail: lf@vortexmakes.com
+ *  ---------------------------------------------------------------------------
+ */
+
+
+/**
+ *  \file   vuart.c
+ *  \brief  Soak harness of the shell over a virtual UART.
+ *
+ *  Runs the shell core against a model of a UART, on a simulated clock. 
+ *  Bytes take ten bit times of the baud rate plus a random jitter, the 
+ *  receiver has a FIFO of given depth that overruns when the shell does 
+ *  not drain it in time, and output blocks the shell while the transmit 
+ *  FIFO is full. Each call of the shell costs a fixed CPU time.
+ *
+ *  The host side sends 'echo T<n> <payload>' lines, mixed with 'help' 
+ *  to load the output, either typed with human gaps waiting for the 
+ *  prompt, or pasted back to back. At the end it reports the characters 
+ *  dropped by overrun, the lines lost or corrupted, the response latency 
+ *  distribution and the throughput of both directions.
+ *
+ *  This file takes the place of conser.c and of the serial driver, the 
+ *  rest of the shell is linked as is, along with the formats of the 
+ *  platform. Built with FLOWCTL, the host stops at XOFF and goes on at 
+ *  XON, then the receive FIFO (-f) should be deeper than FLOWCTL_HIGH:
+ *
+ *      SRC=$(find src -name '*.c' ! -name main.c ! -name conser.c)
+ *      cc -O2 -Iinc -o vuart tools/vuart.c $SRC formats.c
+ *      vuart [-b baud] [-j jitter us] [-f rx fifo] [-F tx fifo] 
+ *            [-c cpu us] [-t seconds] [-m type|paste|mix] [-k key ms] 
+ *            [-w think ms] [-H help %] [-s seed]
+ */
+
+/* -------------------------- Development history -------------------------- */
+/* -------------------------------- Authors -------------------------------- */
+/*
+ *  LeFr  Leandro Francucci  lf@vortexmakes.com
+ */
+
+/* --------------------------------- Notes --------------------------------- */
+/*
+ *  Time is kept in nanoseconds and only moves forward by the shell 
+ *  calls, by the shell waiting on the UART, or by jumping to the next 
+ *  event when the shell is idle, so hours of traffic take seconds and a 
+ *  run is repeated exactly by its seed.
+ *
+ *  A line is matched by the 'T<n>' tag of its response. A response with 
+ *  another payload counts as corrupted, a line without response when 
+ *  its slot is reused or at the end counts as lost. The host stops at a 
+ *  line end when the time is over, and the shell is given a while more 
+ *  to answer the lines on the way.
+ */
+
+/* ----------------------------- Include files ----------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "mytypes.h"
+#include "conser.h"
+#include "shellser.h"
+#include "contick.h"
+#include "simshell.h"
+#include "flowctl.h"
+
+/* ----------------------------- Local macros ------------------------------ */
+#define US                      1000ULL
+#define MS                      1000000ULL
+#define SEC                     1000000000ULL
+#define NEVER                   (~0ULL)
+
+/* ------------------------------- Constants ------------------------------- */
+#define FIFO_MAX                4096
+#define WINDOW                  4096    /* lines waiting for response */
+#define PAYLOAD                 12
+#define HOST_LINE               80
+#define BUCKETS                 40      /* power of two, from 1 us */
+#define TIMEOUT                 (2 * SEC)
+
+/* ---------------------------- Local data types --------------------------- */
+typedef unsigned long long Time;
+
+typedef struct Fifo Fifo;
+struct Fifo
+{
+    unsigned char buf[FIFO_MAX];
+    unsigned int head, count, depth, peak;
+};
+
+typedef struct Sent Sent;
+struct Sent
+{
+    unsigned long id;
+    Time at;
+    char payload[PAYLOAD + 1];
+    int done;
+};
+
+enum
+{
+    MODE_TYPE, MODE_PASTE, MODE_MIX
+};
+
+enum
+{
+    HOST_SEND, HOST_WAIT
+};
+
+/* ---------------------------- Global variables --------------------------- */
+/* ---------------------------- Local variables ---------------------------- */
+static struct
+{
+    unsigned long baud, jitter, cpu, secs, key, think, help, seed;
+    unsigned int rxdepth, txdepth;
+    int mode;
+} opt =
+{
+    115200, 0, 20, 60, 150, 500, 5, 1, 16, 16, MODE_MIX
+};
+
+static Time now, byte_time, tick_at, tx_at, host_at, blocked;
+static Fifo rx, tx;
+static unsigned long rnd;
+
+static struct
+{
+    int state, typed, stop, paused, held;
+    char line[HOST_LINE];
+    unsigned int len, pos;
+    unsigned long id, next_id;
+} host;
+
+static struct
+{
+    char line[HOST_LINE];
+    unsigned int len;
+} peer;
+
+static Sent sent[WINDOW];
+
+static struct
+{
+    unsigned long overruns, lines, helps, xons, ok, corrupt, lost, timeouts;
+    unsigned long prompts;
+    unsigned long long in, out, calls;
+    unsigned long hist[BUCKETS];
+    Time lat_min, lat_max, lat_sum;
+} st;
+
+/* ----------------------- Local function prototypes ----------------------- */
+static void advance(Time to);
+
+/* ---------------------------- Local functions ---------------------------- */
+static unsigned long
+rand32(void)
+{
+    rnd ^= rnd << 13;
+    rnd ^= rnd >> 17;
+    rnd ^= rnd << 5;
+    return rnd & 0xFFFFFFFFUL;
+}
+
+static Time
+uniform(Time max)
+{
+    return max ? (Time)rand32() * max / 0xFFFFFFFFUL : 0;
+}
+
+static Time
+wire(void)
+{
+    return byte_time + uniform(opt.jitter * US);
+}
+
+static int
+fifo_put(Fifo *f, unsigned char c)
+{
+    if (f->count >= f->depth)
+    {
+        return 0;
+    }
+    f->buf[(f->head + f->count++) % FIFO_MAX] = c;
+    if (f->count > f->peak)
+    {
+        f->peak = f->count;
+    }
+    return 1;
+}
+
+static unsigned char
+fifo_get(Fifo *f)
+{
+    unsigned char c = f->buf[f->head];
+
+    f->head = (f->head + 1) % FIFO_MAX;
+    --f->count;
+    return c;
+}
+
+static void
+latency(Time t)
+{
+    unsigned int b;
+
+    for (b = 0; b < BUCKETS - 1 && (t >> b) >= 2 * US; ++b)
+        ;
+    ++st.hist[b];
+    st.lat_sum += t;
+    st.lat_min = st.ok == 1 || t < st.lat_min ? t : st.lat_min;
+    st.lat_max = t > st.lat_max ? t : st.lat_max;
+}
+
+static void
+forget(Sent *s)
+{
+    if (s->id != 0 && !s->done)
+    {
+        ++st.lost;
+    }
+    s->id = 0;
+}
+
+static void
+new_line(void)
+{
+    Sent *s;
+    unsigned int i, n;
+
+    host.typed = opt.mode == MODE_TYPE ||
+                 (opt.mode == MODE_MIX && (rand32() & 1));
+    host.pos = 0;
+
+    if (rand32() % 100 < opt.help)
+    {
+        host.id = 0;
+        host.len = sprintf(host.line, "help\r");
+        return;
+    }
+
+    host.id = ++host.next_id;
+    s = &sent[host.id % WINDOW];
+    forget(s);
+    s->id = host.id;
+    s->done = 0;
+    n = 1 + rand32() % PAYLOAD;
+    for (i = 0; i < n; ++i)
+    {
+        s->payload[i] = "abcdefghijklmnopqrstuvwxyz0123456789"[rand32() % 36];
+    }
+    s->payload[n] = '\0';
+    host.len = sprintf(host.line, "echo T%lu %s\r", host.id, s->payload);
+}
+
+static void
+host_next(Time gap)
+{
+    host.state = HOST_SEND;
+    if (host.paused)
+    {
+        host.held = 1;              /* until XON */
+        host_at = NEVER;
+        return;
+    }
+    host_at = now + gap + wire();
+}
+
+static void
+host_event(void)
+{
+    char c;
+
+    if (host.state == HOST_WAIT)
+    {
+        ++st.timeouts;
+        new_line();
+        host_next(0);
+        return;
+    }
+
+    c = host.line[host.pos++];
+    ++st.in;
+    if (!fifo_put(&rx, (unsigned char)c))
+    {
+        ++st.overruns;
+    }
+#if FLOWCTL
+    else
+    {
+        flowctl_rx();
+    }
+#endif
+
+    if (host.pos < host.len)
+    {
+        host_next(host.typed ? uniform(2 * opt.key * MS) : 0);
+        return;
+    }
+
+    if (host.id != 0)
+    {
+        ++st.lines;
+        sent[host.id % WINDOW].at = now;
+    }
+    else
+    {
+        ++st.helps;
+    }
+    if (host.stop)
+    {
+        host_at = NEVER;
+    }
+    else if (host.typed)
+    {
+        host.state = HOST_WAIT;
+        host_at = now + TIMEOUT;
+    }
+    else
+    {
+        new_line();
+        host_next(0);
+    }
+}
+
+static void
+response(const char *line)
+{
+    unsigned long id;
+    char *end;
+    Sent *s;
+
+    if (line[0] != 'T' || (id = strtoul(line + 1, &end, 10)) == 0 ||
+        *end != ' ')
+    {
+        return;
+    }
+
+    s = &sent[id % WINDOW];
+    if (s->id != id || s->done)
+    {
+        return;
+    }
+    s->done = 1;
+    if (strcmp(end + 1, s->payload) != 0)
+    {
+        ++st.corrupt;
+        return;
+    }
+    ++st.ok;
+    latency(now - s->at);
+}
+
+static void
+peer_rx(char c)
+{
+    ++st.out;
+    if (c == '\r')
+    {
+        return;
+    }
+    if (c == '\n')
+    {
+        peer.line[peer.len] = '\0';
+        response(peer.line);
+        peer.len = 0;
+        return;
+    }
+    if (peer.len < HOST_LINE - 1)
+    {
+        peer.line[peer.len++] = c;
+    }
+    if (peer.len == 2 && peer.line[0] == '>' && peer.line[1] == '>')
+    {
+        ++st.prompts;
+        if (host.state == HOST_WAIT && !host.stop)
+        {
+            new_line();
+            host_next(uniform(2 * opt.think * MS));
+        }
+    }
+}
+
+static Time
+next_event(void)
+{
+    Time t = tick_at;
+
+    t = host_at < t ? host_at : t;
+    t = tx.count && tx_at < t ? tx_at : t;
+    return t;
+}
+
+static void
+advance(Time to)
+{
+    Time t;
+
+    while ((t = next_event()) <= to)
+    {
+        now = t;
+        if (t == tick_at)
+        {
+            tick_at += MS;
+            contick_tick();
+        }
+        else if (t == host_at)
+        {
+            host_event();
+        }
+        else
+        {
+            peer_rx((char)fifo_get(&tx));
+            tx_at += wire();
+        }
+    }
+    now = to;
+}
+
+static void
+report(void)
+{
+    unsigned int b;
+    unsigned long n, p50, p90, p99, acc;
+    double secs = (double)now / SEC;
+#if FLOWCTL
+    FlowCtlStat fc;
+#endif
+
+    printf("%.0f s at %lu baud, jitter %lu us, fifo %u/%u, cpu %lu us, "
+           "seed %lu\n", secs, opt.baud, opt.jitter, opt.rxdepth,
+           opt.txdepth, opt.cpu, opt.seed);
+    printf("lines %lu, ok %lu, lost %lu, corrupt %lu, timeouts %lu, "
+           "help %lu, prompts %lu\n", st.lines, st.ok, st.lost, st.corrupt,
+           st.timeouts, st.helps, st.prompts);
+    printf("dropped %lu of %llu chars, rx fifo peak %u, tx fifo peak %u, "
+           "%.1f%% blocked on output\n", st.overruns, st.in, rx.peak,
+           tx.peak, 100.0 * blocked / (now ? now : 1));
+#if FLOWCTL
+    flowctl_stat(&fc);
+    printf("xoff %lu, xon %lu, late %lu, pending peak %u, watermarks "
+           "%u/%u\n", fc.xoffs, st.xons, fc.late, fc.peak, FLOWCTL_HIGH,
+           FLOWCTL_LOW);
+#endif
+    printf("in %.0f B/s, out %.0f B/s, link %.1f%%/%.1f%%, %.1f lines/s, "
+           "%llu calls\n", st.in / secs, st.out / secs,
+           100.0 * st.in * byte_time / now, 100.0 * st.out * byte_time / now,
+           st.ok / secs, st.calls);
+
+    if (st.ok == 0)
+    {
+        return;
+    }
+    printf("latency min %.3f ms, avg %.3f ms, max %.3f ms\n",
+           (double)st.lat_min / MS, (double)st.lat_sum / st.ok / MS,
+           (double)st.lat_max / MS);
+
+    p50 = p90 = p99 = BUCKETS;
+    for (b = 0, acc = 0; b < BUCKETS; ++b)
+    {
+        if ((n = st.hist[b]) == 0)
+        {
+            continue;
+        }
+        acc += n;
+        p50 = p50 == BUCKETS && acc * 2 >= st.ok ? b : p50;
+        p90 = p90 == BUCKETS && acc * 10 >= st.ok * 9 ? b : p90;
+        p99 = p99 == BUCKETS && acc * 100 >= st.ok * 99 ? b : p99;
+        printf("  < %10.3f ms %8lu %5.1f%%\n", (double)(2 * US << b) / MS,
+               n, 100.0 * n / st.ok);
+    }
+    printf("p50 < %.3f ms, p90 < %.3f ms, p99 < %.3f ms\n",
+           (double)(2 * US << p50) / MS, (double)(2 * US << p90) / MS,
+           (double)(2 * US << p99) / MS);
+}
+
+static int
+usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-b baud] [-j jitter us] [-f rx fifo] "
+            "[-F tx fifo] [-c cpu us] [-t seconds] [-m type|paste|mix] "
+            "[-k key ms] [-w think ms] [-H help %%] [-s seed]\n", name);
+    return EXIT_FAILURE;
+}
+
+/* ---------------------------- Global functions --------------------------- */
+void
+shellser_init(void)
+{
+}
+
+MUInt
+shellser_tstc(void)
+{
+    return rx.count == 0;
+}
+
+MUInt
+shellser_getc(void)
+{
+    while (rx.count == 0)
+    {
+        advance(next_event());
+    }
+    FLOWCTL_TAKE();
+    return fifo_get(&rx);
+}
+
+void
+shellser_putc(const char c)
+{
+    Time t = now;
+
+    while (!fifo_put(&tx, (unsigned char)c))
+    {
+        advance(tx_at);
+    }
+    if (tx.count == 1)
+    {
+        tx_at = now + wire();
+    }
+    blocked += now - t;
+    SIMSHELL_TX(1);
+}
+
+void
+shellser_puts(const char *s)
+{
+    while (*s != '\0')
+    {
+        shellser_putc(*s++);
+    }
+}
+
+void
+conser_init(void)
+{
+}
+
+MUInt
+conser_tstc(void)
+{
+    return shellser_tstc();
+}
+
+MUInt
+conser_getc(void)
+{
+    return shellser_getc();
+}
+
+void
+conser_putc(const char c)
+{
+    shellser_putc(c);
+}
+
+void
+conser_puts(const char *s)
+{
+    shellser_puts(s);
+}
+
+#if FLOWCTL
+/* The host sees XON and XOFF at once, but the byte on the way arrives */
+void
+conser_flow(int ready)
+{
+    host.paused = !ready;
+    if (ready)
+    {
+        ++st.xons;
+    }
+    if (ready && host.held)
+    {
+        host.held = 0;
+        host_at = now + wire();
+    }
+}
+#endif
+
+int
+main(int argc, char *argv[])
+{
+    int c, busy;
+    Time end, quiet, t;
+
+    while ((c = getopt(argc, argv, "b:j:f:F:c:t:m:k:w:H:s:")) != -1)
+    {
+        switch (c)
+        {
+            case 'b': opt.baud = strtoul(optarg, NULL, 0); break;
+            case 'j': opt.jitter = strtoul(optarg, NULL, 0); break;
+            case 'f': opt.rxdepth = strtoul(optarg, NULL, 0); break;
+            case 'F': opt.txdepth = strtoul(optarg, NULL, 0); break;
+            case 'c': opt.cpu = strtoul(optarg, NULL, 0); break;
+            case 't': opt.secs = strtoul(optarg, NULL, 0); break;
+            case 'k': opt.key = strtoul(optarg, NULL, 0); break;
+            case 'w': opt.think = strtoul(optarg, NULL, 0); break;
+            case 'H': opt.help = strtoul(optarg, NULL, 0); break;
+            case 's': opt.seed = strtoul(optarg, NULL, 0); break;
+            case 'm':
+                opt.mode = strcmp(optarg, "type") == 0 ? MODE_TYPE :
+                           strcmp(optarg, "paste") == 0 ? MODE_PASTE :
+                           strcmp(optarg, "mix") == 0 ? MODE_MIX : -1;
+                break;
+            default: return usage(argv[0]);
+        }
+    }
+    if (opt.baud == 0 || opt.rxdepth == 0 || opt.rxdepth > FIFO_MAX ||
+        opt.txdepth == 0 || opt.txdepth > FIFO_MAX || opt.mode < 0 ||
+        opt.seed == 0)
+    {
+        return usage(argv[0]);
+    }
+
+    rnd = opt.seed;
+    rx.depth = opt.rxdepth;
+    tx.depth = opt.txdepth;
+    byte_time = 10 * SEC / opt.baud;
+    tick_at = MS;
+    host.state = HOST_WAIT;             /* until the first prompt */
+    host_at = TIMEOUT;
+    end = opt.secs * SEC;
+
+    simshell_init();
+    for (quiet = 0; quiet == 0 || now < quiet; )
+    {
+        if (now >= end && !host.stop)
+        {
+            host.stop = 1;
+            if (host.state == HOST_SEND && host.pos == 0)
+            {
+                sent[host.id % WINDOW].id = 0;  /* not sent yet */
+                host_at = NEVER;
+                host.held = 0;
+            }
+            if (host.state == HOST_WAIT)
+            {
+                host_at = NEVER;
+            }
+        }
+        if (host.stop && host_at == NEVER && !host.held && quiet == 0)
+        {
+            quiet = now + TIMEOUT;
+        }
+        ++st.calls;
+#if BUDGET
+        busy = simshell_slice(0, opt.txdepth) == SIMSHELL_MORE;
+#else
+        simshell_process(0);
+        busy = rx.count != 0;
+#endif
+        t = now + opt.cpu * US;
+        if (!busy && next_event() > t)
+        {
+            t = next_event();           /* idle until something happens */
+        }
+        advance(t);
+    }
+
+    for (c = 0; c < WINDOW; ++c)
+    {
+        forget(&sent[c]);
+    }
+    report();
+    return EXIT_SUCCESS;
+}
+
+/* ------------------------------ End of file ------------------------------ */